@@ -0,0 +1,328 @@
+//----------------------------------------------------------------------
+//
+// File Name   : bench.h
+// Subsystem   : XFF benchmarks
+// Description : Minimal timing harness for the XTime benchmarks
+//
+// .SECTION DESCRIPTION
+// Each benchmark is a function object op(i) that performs one
+// operation on input number i and returns a double, which is
+// accumulated in a volatile sink so that the work cannot be
+// optimized away.  benchRun times nops calls, after one untimed
+// warm-up run, and reports the best of reps runs in ns/op and ops/s.
+// Results can also be written as JSON:
+//   {"suite": "<executable>", "results": [{"name": ..., "ns_per_op": ...,
+//    "ops_per_s": ..., <extra fields>}, ...]}
+//
+// With -c the hardware counters in benchCounterDef (cycles,
+// instructions, branch misses, L1 data and last level cache read
+// misses) are also counted through the Linux perf_event_open system
+// call, over all timed runs, and reported per operation.  Counters
+// that cannot be opened (no PMU, perf_event_paranoid, not Linux)
+// are left out with a warning; the timing is not affected.
+//
+// Options common to all benchmark executables (benchArgs):
+//   -n nops     Operations per timed run, or the largest problem size
+//               (meaning and default per executable)
+//   -r reps     Timed runs per benchmark; the fastest is reported
+//   -j file     Also write the results to file as JSON
+//   -c          Also count hardware events
+//   pattern     Only run benchmarks whose name contains pattern
+//
+//----------------------------------------------------------------------
+//
+
+#ifndef BENCH_H
+#define BENCH_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+static volatile double benchSink ;  // Results of all operations
+static long benchNops = 0 ;         // Operations per timed run
+static int benchReps = 5 ;          // Timed runs per benchmark
+static const char *benchPattern = NULL ; // Benchmark name filter
+static FILE *benchJson = NULL ;     // JSON output file
+static int benchJsonCount = 0 ;     // Results written to benchJson
+
+//  Hardware counters
+
+static const int BENCH_NCOUNTERS = 5 ;
+static struct {
+  const char *name ;                   // Name in the output
+  unsigned int type ;                  // perf_event_attr type
+  unsigned long long config ;          // perf_event_attr config
+} benchCounterDef[BENCH_NCOUNTERS] = {
+#ifdef __linux__
+  {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+  {"l1d_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+   | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 )},
+  {"llc_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL
+   | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 )}
+#else
+  {"cycles", 0, 0}, {"instructions", 0, 0}, {"branch_misses", 0, 0},
+  {"l1d_misses", 0, 0}, {"llc_misses", 0, 0}
+#endif
+} ;
+static int benchCounterFd[BENCH_NCOUNTERS] = {-1, -1, -1, -1, -1} ;
+static int benchNumCounters = 0 ;   // Counters that could be opened
+
+//
+//   ----------
+// -- benchNow --
+//   ----------
+//
+
+// Description:
+// Return a monotonic wall clock reading in ns.
+inline double benchNow (void)
+{
+  struct timespec ts ;
+  clock_gettime (CLOCK_MONOTONIC, &ts) ;
+  return ts.tv_sec * 1.0e9 + ts.tv_nsec ;
+}
+
+//
+//   -------------
+// -- benchRecord --
+//   -------------
+//
+
+// Description:
+// Write one result to the JSON output, if any; extra is NULL or a
+// string of additional JSON members (e.g. "\"size\": 10").
+inline void benchRecord (const char *name, double ns, const char *extra=NULL)
+{
+  if ( !benchJson )
+    return ;
+  fprintf (benchJson, "%s\n  {\"name\": \"%s\", \"ns_per_op\": %.4g, \"ops_per_s\": %.6g",
+	   benchJsonCount++ ? "," : "", name, ns, ( ns > 0.0 ) ? 1.0e9 / ns : 0.0) ;
+  if ( extra && *extra )
+    fprintf (benchJson, ", %s", extra) ;
+  fprintf (benchJson, "}") ;
+}
+
+//
+//   ----------------
+// -- benchJsonClose --
+//   ----------------
+//
+
+// Description:
+// Terminate and close the JSON output (registered with atexit).
+inline void benchJsonClose (void)
+{
+  if ( benchJson ) {
+    fprintf (benchJson, "\n]}\n") ;
+    fclose (benchJson) ;
+    benchJson = NULL ;
+  }
+}
+
+//
+//   -------------------
+// -- benchCountersOpen --
+//   -------------------
+//
+
+// Description:
+// Open the hardware counters, disabled; return the number opened.
+// Each counter is a separate event, so that one the CPU does not
+// support does not take the others with it; if the kernel has to
+// multiplex them the counts are scaled in benchCountersStop.
+inline int benchCountersOpen (void)
+{
+  benchNumCounters = 0 ;
+#ifdef __linux__
+  for (int c=0; c<BENCH_NCOUNTERS; c++) {
+    struct perf_event_attr attr ;
+    memset (&attr, 0, sizeof (attr)) ;
+    attr.size = sizeof (attr) ;
+    attr.type = benchCounterDef[c].type ;
+    attr.config = benchCounterDef[c].config ;
+    attr.disabled = 1 ;
+    attr.exclude_kernel = 1 ;
+    attr.exclude_hv = 1 ;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING ;
+    benchCounterFd[c] = (int) syscall (SYS_perf_event_open, &attr, 0, -1, -1, 0) ;
+    if ( benchCounterFd[c] >= 0 )
+      benchNumCounters++ ;
+    else
+      fprintf (stderr, "Counter %s unavailable: %s\n", benchCounterDef[c].name, strerror (errno)) ;
+  }
+#else
+  fprintf (stderr, "Hardware counters are only supported on Linux\n") ;
+#endif
+  if ( !benchNumCounters )
+    fprintf (stderr, "No hardware counters; reporting timing only\n") ;
+  return benchNumCounters ;
+}
+
+//
+//   --------------------
+// -- benchCountersStart --
+//   --------------------
+//
+
+// Description:
+// Reset and enable the open counters.
+inline void benchCountersStart (void)
+{
+#ifdef __linux__
+  for (int c=0; c<BENCH_NCOUNTERS; c++)
+    if ( benchCounterFd[c] >= 0 ) {
+      ioctl (benchCounterFd[c], PERF_EVENT_IOC_RESET, 0) ;
+      ioctl (benchCounterFd[c], PERF_EVENT_IOC_ENABLE, 0) ;
+    }
+#endif
+}
+
+//
+//   -------------------
+// -- benchCountersStop --
+//   -------------------
+//
+
+// Description:
+// Disable the open counters and add their counts to counts[];
+// counters that are not open, or never got scheduled, are set to -1.
+inline void benchCountersStop (double counts[BENCH_NCOUNTERS])
+{
+  for (int c=0; c<BENCH_NCOUNTERS; c++) {
+    double value = -1.0 ;
+#ifdef __linux__
+    unsigned long long buf[3] ;   // value, time enabled, time running
+    if ( ( benchCounterFd[c] >= 0 )
+	 && !ioctl (benchCounterFd[c], PERF_EVENT_IOC_DISABLE, 0)
+	 && ( read (benchCounterFd[c], buf, sizeof (buf)) == sizeof (buf) )
+	 && buf[2] )
+      value = (double) buf[0] * ( (double) buf[1] / buf[2] ) ;
+#endif
+    if ( ( value < 0.0 ) || ( counts[c] < 0.0 ) )
+      counts[c] = -1.0 ;
+    else
+      counts[c] += value ;
+  }
+}
+
+//
+//   ---------------------
+// -- benchCountersReport --
+//   ---------------------
+//
+
+// Description:
+// Print the counts per operation (nops operations) to stdout,
+// continuing the current line, and append them to the JSON members
+// in extra (of size len).
+inline void benchCountersReport (const double counts[BENCH_NCOUNTERS], double nops,
+				 char *extra, size_t len)
+{
+  size_t n = strlen (extra) ;
+  for (int c=0; c<BENCH_NCOUNTERS; c++) {
+    if ( counts[c] < 0.0 )
+      continue ;
+    printf (" %10.2f %s", counts[c] / nops, benchCounterDef[c].name) ;
+    if ( n < len )
+      n += snprintf (extra + n, len - n, "%s\"%s\": %.6g",
+		     n ? ", " : "", benchCounterDef[c].name, counts[c] / nops) ;
+  }
+}
+
+//
+//   -----------
+// -- benchArgs --
+//   -----------
+//
+
+// Description:
+// Parse the common command line options (see above); nops is the
+// default number of operations per run.
+inline void benchArgs (int argc, char **argv, long nops)
+{
+  benchNops = nops ;
+  for (int i=1; i<argc; i++) {
+    if ( !strcmp (argv[i], "-n") && ( i+1 < argc ) )
+      benchNops = atol (argv[++i]) ;
+    else if ( !strcmp (argv[i], "-r") && ( i+1 < argc ) )
+      benchReps = atoi (argv[++i]) ;
+    else if ( !strcmp (argv[i], "-j") && ( i+1 < argc ) ) {
+      if ( ( benchJson = fopen (argv[++i], "w") ) == NULL ) {
+	perror (argv[i]) ;
+	exit (1) ;
+      }
+      const char *suite = strrchr (argv[0], '/') ;
+      fprintf (benchJson, "{\"suite\": \"%s\", \"results\": [", suite ? suite+1 : argv[0]) ;
+      atexit (benchJsonClose) ;
+    }
+    else if ( !strcmp (argv[i], "-c") )
+      benchCountersOpen () ;
+    else if ( argv[i][0] == '-' ) {
+      fprintf (stderr, "Usage: %s [-n nops] [-r reps] [-j file] [-c] [pattern]\n", argv[0]) ;
+      exit (1) ;
+    }
+    else
+      benchPattern = argv[i] ;
+  }
+  if ( benchNops < 1 )
+    benchNops = 1 ;
+  if ( benchReps < 1 )
+    benchReps = 1 ;
+}
+
+//
+//   ----------
+// -- benchRun --
+//   ----------
+//
+
+// Description:
+// Time benchNops calls of op(i), i = 0 ... benchNops-1, and print
+// the best time per operation, and the hardware counts per operation
+// averaged over the timed runs if they are enabled.  Return ns/op, or 0 if the benchmark
+// was skipped because its name does not match the pattern.
+template <class Op>
+double benchRun (const char *name, Op op)
+{
+  if ( benchPattern && !strstr (name, benchPattern) )
+    return 0.0 ;
+
+  double best = 0.0 ;
+  double counts[BENCH_NCOUNTERS] = {0.0} ;
+  for (int r=-1; r<benchReps; r++) {
+    double sum = 0.0 ;
+    if ( benchNumCounters && ( r >= 0 ) )
+      benchCountersStart () ;
+    double t0 = benchNow () ;
+    for (long i=0; i<benchNops; i++)
+      sum += op (i) ;
+    double t = benchNow () - t0 ;
+    if ( benchNumCounters && ( r >= 0 ) )
+      benchCountersStop (counts) ;
+    benchSink = benchSink + sum ;
+    if ( ( r == 0 ) || ( ( r > 0 ) && ( t < best ) ) )
+      best = t ;
+  }
+
+  double ns = best / benchNops ;
+  char extra[512] = "" ;
+  printf ("%-40s %10.1f ns/op %14.0f ops/s", name, ns, 1.0e9 / ns) ;
+  if ( benchNumCounters )
+    benchCountersReport (counts, (double) benchNops * benchReps, extra, sizeof (extra)) ;
+  printf ("\n") ;
+  fflush (stdout) ;
+  benchRecord (name, ns, extra) ;
+  return ns ;
+}
+
+#endif
@@ -0,0 +1,229 @@
+# Licensed under a 3-clause BSD style license - see LICENSE.rst
+"""
+Benchmarks for the chandra_time Python interface.
+
+Times ``DateTime(x, format=fmt).<out>`` for every input format in
+``time_styles`` and ``out`` in secs, date, fits, caldate and jd, and
+``convert_vals``, ``date2secs`` and ``secs2date``, for scalar, list and numpy
+array inputs of 1 to 10**7 elements.  A size is skipped when the growth from
+the previous sizes predicts that one call would take more than ``--budget``
+seconds.  This is not part of the test suite; run it by hand::
+
+  python bench/bench_time.py --save baseline.json        # on the reference build
+  python bench/bench_time.py --compare baseline.json     # after a change
+
+With ``--compare`` every benchmark that is slower than the baseline by more
+than ``--threshold`` (a fraction, default 0.2) is flagged as a regression and
+the exit status is 1.  The JSON has the same layout as the output of the C++
+benchmarks (``bench/*_bench -j``).  ``bench/regress.py`` runs this suite and
+the C++ benchmarks against the baseline checked in as ``bench/baseline.json``.
+"""
+import argparse
+import json
+import platform
+import sys
+import time
+import warnings
+
+import numpy as np
+
+from chandra_time import Time
+from chandra_time.Time import (DateTime, FAST_FORMATS, convert, convert_vals,
+                               date2secs, secs2date, time_styles)
+
+DATETIME_OUTPUTS = ('secs', 'date', 'fits', 'caldate', 'jd')
+KINDS = ('scalar', 'list', 'array')
+POOL_SIZE = 1000  # Distinct input values; larger inputs repeat them
+
+
+def get_pools():
+    """
+    Return a dict of input pools (numpy arrays of POOL_SIZE values) for every
+    time style that can be produced and read back here.  The times are spread
+    over 2000 to 2020, so 'relday' values are negative as that format needs.
+    """
+    rng = np.random.RandomState(1)
+    secs = np.sort(rng.uniform(DateTime('2000:001').secs, DateTime('2020:001').secs,
+                               POOL_SIZE))
+    pools = {}
+    for time_style in time_styles:
+        try:
+            vals = np.asarray(convert(secs, fmt_out=time_style.name))
+            DateTime(vals[:2], format=time_style.name).secs
+        except Exception as err:
+            print('Skipping input format {}: {}'.format(time_style.name, err))
+            continue
+        pools[time_style.name] = vals
+    return pools
+
+
+def make_input(pool, kind, size):
+    """Return ``size`` values from ``pool`` as a scalar, list or array."""
+    if kind == 'scalar':
+        return pool[0].tolist()
+    vals = np.resize(pool, size)
+    return vals.tolist() if kind == 'list' else vals
+
+
+def time_call(func, arg, repeat, min_time=0.05):
+    """
+    Return the best time in ns of ``func(arg)`` over ``repeat`` runs, where
+    each run makes enough calls to last at least ``min_time`` seconds.
+    """
+    func(arg)  # warm up
+    number = 1
+    while True:
+        t0 = time.perf_counter()
+        for _ in range(number):
+            func(arg)
+        dt = time.perf_counter() - t0
+        if dt >= min_time or number >= 1e6:
+            break
+        number *= 10 if dt < min_time / 10 else 2
+    best = dt / number
+    for _ in range(repeat - 1):
+        t0 = time.perf_counter()
+        for _ in range(number):
+            func(arg)
+        best = min(best, (time.perf_counter() - t0) / number)
+    return best * 1e9
+
+
+class Runner(object):
+    """
+    Run benchmarks and collect the results in ``self.results``.
+
+    :param sizes: input sizes for list and array inputs
+    :param budget: skip sizes predicted to take longer than this (seconds/call)
+    :param repeat: timed runs per benchmark (the fastest is used)
+    :param pattern: only run benchmarks whose name contains this
+    :param min_time: minimum duration of each timed run (seconds)
+    """
+    def __init__(self, sizes, budget, repeat, pattern=None, min_time=0.05):
+        self.sizes = sizes
+        self.budget = budget
+        self.repeat = repeat
+        self.pattern = pattern
+        self.min_time = min_time
+        self.results = []
+
+    def run(self, group, func, pool, kinds=KINDS):
+        """
+        Time ``func(x)`` with ``x`` made from ``pool`` for each kind and size.
+        The result names are '<group> <kind> n=<size>'.
+        """
+        for kind in kinds:
+            last_ns = 0.0
+            growth = 10.0
+            for size in ([1] if kind == 'scalar' else self.sizes):
+                name = '{} {} n={}'.format(group, kind, size)
+                if self.pattern and self.pattern not in name:
+                    continue
+                if last_ns * growth > self.budget * 1e9:
+                    print('{:52s} {:>14s}'.format(name, 'skipped'))
+                    self.results.append({'name': name, 'ns_per_op': 0.0, 'ops_per_s': 0.0,
+                                         'kind': kind, 'size': size, 'skipped': True})
+                    continue
+                ns = time_call(func, make_input(pool, kind, size), self.repeat,
+                               self.min_time)
+                if last_ns > 0:
+                    growth = ns / last_ns
+                last_ns = ns
+                print('{:52s} {:14.1f} ns/call {:10.1f} ns/elem'.format(name, ns, ns / size))
+                sys.stdout.flush()
+                self.results.append({'name': name, 'ns_per_op': ns, 'ops_per_s': 1e9 / ns,
+                                     'kind': kind, 'size': size, 'ns_per_elem': ns / size})
+
+
+def run_benchmarks(runner):
+    """Run all the benchmarks with ``runner``."""
+    pools = get_pools()
+
+    for fmt_in, pool in pools.items():
+        for fmt_out in DATETIME_OUTPUTS:
+            runner.run('DateTime({}).{}'.format(fmt_in, fmt_out),
+                       lambda x: getattr(DateTime(x, format=fmt_in), fmt_out), pool)
+
+    for fmt_in in sorted(FAST_FORMATS & set(pools)):
+        for fmt_out in sorted(FAST_FORMATS):
+            if fmt_out != fmt_in:
+                runner.run('convert_vals({},{})'.format(fmt_in, fmt_out),
+                           lambda x: convert_vals(x, fmt_in, fmt_out), pools[fmt_in])
+
+    runner.run('date2secs', date2secs, pools['date'])
+    runner.run('secs2date', secs2date, pools['secs'])
+
+
+def compare(results, baseline, threshold):
+    """
+    Compare ``results`` with ``baseline`` (lists of result dicts) and print the
+    benchmarks that are slower by more than ``threshold``.  Returns the number
+    of regressions.
+    """
+    base = {res['name']: res for res in baseline if res.get('ns_per_op', 0) > 0}
+    regressions = 0
+    compared = 0
+    for res in results:
+        old = base.get(res['name'])
+        if old is None or not res.get('ns_per_op', 0) > 0:
+            continue
+        compared += 1
+        ratio = res['ns_per_op'] / old['ns_per_op']
+        if ratio > 1 + threshold:
+            regressions += 1
+            print('REGRESSION {:52s} {:12.1f} -> {:12.1f} ns ({:+.0%})'
+                  .format(res['name'], old['ns_per_op'], res['ns_per_op'], ratio - 1))
+    print('Compared {} benchmarks with the baseline: {} regressions beyond {:.0%}'
+          .format(compared, regressions, threshold))
+    return regressions
+
+
+def get_parser():
+    parser = argparse.ArgumentParser(description='Benchmark the chandra_time Python interface')
+    parser.add_argument('pattern', nargs='?',
+                        help='Only run benchmarks whose name contains this')
+    parser.add_argument('--max-size', type=float, default=1e7,
+                        help='Largest list/array size (default=1e7)')
+    parser.add_argument('--budget', type=float, default=5.0,
+                        help='Skip sizes predicted to take longer than this per call '
+                        '(seconds, default=5)')
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='Timed runs per benchmark (default=3)')
+    parser.add_argument('--min-time', type=float, default=0.05,
+                        help='Minimum duration of each timed run (seconds, default=0.05)')
+    parser.add_argument('--save', help='Write the results to this JSON file')
+    parser.add_argument('--compare', help='Compare with this baseline JSON file')
+    parser.add_argument('--threshold', type=float, default=0.2,
+                        help='Slowdown flagged as a regression (fraction, default=0.2)')
+    return parser
+
+
+def main(args=None):
+    opt = get_parser().parse_args(args)
+    sizes = [10 ** i for i in range(int(np.log10(opt.max_size)) + 1)]
+    runner = Runner(sizes, opt.budget, opt.repeat, opt.pattern, opt.min_time)
+
+    with warnings.catch_warnings():
+        warnings.simplefilter('ignore')
+        run_benchmarks(runner)
+
+    if opt.save:
+        out = {'suite': 'bench_time',
+               'python': platform.python_version(),
+               'numpy': np.__version__,
+               'platform': platform.platform(),
+               'module': Time.__file__,
+               'results': runner.results}
+        with open(opt.save, 'w') as fh:
+            json.dump(out, fh, indent=1)
+
+    if opt.compare:
+        with open(opt.compare) as fh:
+            baseline = json.load(fh)['results']
+        if compare(runner.results, baseline, opt.threshold):
+            return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,286 @@
+//----------------------------------------------------------------------
+//
+// File Name   : leap_bench.cc
+// Subsystem   : XFF benchmarks
+// Description : Leap second boundary sweep: cost and round trips
+//
+// .SECTION DESCRIPTION
+// Sweeps MET across +-2 s around every leap second in the table
+// (LEAPSMJD, except the 1972.0 entry, which is not a leap second) in
+// steps of step us, and for every time
+//   - verifies the round trips in all formats:
+//       UTC and TT date strings (DATE, CALDATE, FITS; 6 decimals):
+//         date -> XTime -> same date, and within 1.5 us of the MET
+//       UTC and TT MJD and JD (integer and fraction): MJD -> XTime ->
+//         the same MJD within 1 us, and for TT within 1 us of the MET
+//         (UTC MJD cannot represent the leap second itself: it maps
+//         to the first second of the next day)
+//     and that the UTC DATE strings increase strictly over the sweep,
+//     with exactly 1 s worth of them in second 60;
+//   - verifies that UTC seconds across the same leap seconds set as
+//     integer nanoseconds (setNanos) give the same MET as set from the
+//     seconds, also with a time correction term (setTZero) of 0.5 s;
+//   - classifies it by the path getDate takes: "inside" for the
+//     leap second itself (leapflag set: second++, hour-- and
+//     minute--), "outside" for the seconds around it.
+// The cost per call of the set and getDate calls is then measured
+// separately for the two classes.  The exit status is 1 if any round
+// trip fails.
+//
+// Usage: leap_bench [-n step] [-r reps] [-j file] [-c] [pattern]
+//   step    Sweep step in microseconds (default 250)
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "XTime.h"
+#include "bench.h"
+
+static const char *const SYSNAME[] = {"MET", "TT", "UTC", "TAI"} ;
+static const char *const FORMNAME[] = {"SECS", "JD", "MJD", "DATE", "CALDATE", "FITS"} ;
+static const int DEC = 6 ;            // Decimals in the date strings
+static const long MJDREF = 50814 ;    // MJD (TT) of MET 0
+
+static long nfail = 0 ;
+
+//
+//   ------
+// -- fail --
+//   ------
+//
+
+// Description:
+// Count a failed round trip and report the first few.
+static void fail (double met, const char *what, const char *got, const char *expect)
+{
+  if ( nfail++ < 20 )
+    printf ("FAIL MET %.6f %s: got %s, expected %s\n", met, what, got, expect) ;
+}
+
+//
+//   --------
+// -- verify --
+//   --------
+//
+
+// Description:
+// Check the round trips of one time; return 1 if it is inside a leap
+// second.
+static int verify (double met)
+{
+  static const XTime::TimeSys sys[2] = {XTime::UTC, XTime::TT} ;
+  char what[64], got[64], expect[64] ;
+  XTime T (met) ;
+  XTime U ;
+  std::string date = T.getDate (XTime::UTC, XTime::DATE, DEC) ;
+  int inside = ( date.compare (14, 3, ":60") == 0 ) ;
+
+  for (int s=0; s<2; s++) {
+    for (int tf=XTime::DATE; tf<=XTime::FITS; tf++) {
+      std::string d = T.getDate (sys[s], (XTime::TimeFormat) tf, DEC) ;
+      snprintf (what, sizeof (what), "%s %s", SYSNAME[sys[s]], FORMNAME[tf]) ;
+      if ( U.set (d.c_str (), sys[s], (XTime::TimeFormat) tf) ) {
+	fail (met, what, "parse error", d.c_str ()) ;
+	continue ;
+      }
+      if ( fabs (U.getMET () - met) > 1.5e-6 ) {
+	snprintf (got, sizeof (got), "MET %.6f", U.getMET ()) ;
+	fail (met, what, got, d.c_str ()) ;
+      }
+      const char *d2 = U.getDate (sys[s], (XTime::TimeFormat) tf, DEC) ;
+      if ( d != d2 )
+	fail (met, what, d2, d.c_str ()) ;
+    }
+
+    long k, k2 ;
+    double x, x2 ;
+    T.mjd (&k, &x, sys[s]) ;
+    for (int tf=XTime::JD; tf<=XTime::MJD; tf++) {
+      if ( tf == XTime::JD )
+	U.set (k + 2400000L, x + 0.5, sys[s], XTime::JD) ;
+      else
+	U.set (k, x, sys[s], XTime::MJD) ;
+      U.mjd (&k2, &x2, sys[s]) ;
+      double dt = fabs ((k2 - k) + (x2 - x)) * 86400.0 ;
+      if ( ( sys[s] == XTime::TT ) && ( fabs (U.getMET () - met) > dt ) )
+	dt = fabs (U.getMET () - met) ;
+      if ( dt > 1.0e-6 ) {
+	snprintf (what, sizeof (what), "%s %s", SYSNAME[sys[s]], FORMNAME[tf]) ;
+	snprintf (got, sizeof (got), "%ld %.12f", k2, x2) ;
+	snprintf (expect, sizeof (expect), "%ld %.12f", k, x) ;
+	fail (met, what, got, expect) ;
+      }
+    }
+  }
+
+  return inside ;
+}
+
+//
+//   -------------
+// -- verifyNanos --
+//   -------------
+//
+
+// Description:
+// Check that UTC seconds utc set as integer nanoseconds give the same
+// MET as set from the seconds, with time correction terms 0 and 0.5 s,
+// for the leap second that starts at UTC seconds start.  Within 1 us
+// of either end of the leap second set's day fractions may round
+// either way, and those times are not checked.
+static void verifyNanos (double utc, double start)
+{
+  char what[64], got[64], expect[64] ;
+  XTime U, V ;
+  for (int z=0; z<2; z++) {
+    double t = utc + 0.5 * z - start ;
+    if ( ( fabs (t) < 1.0e-6 ) || ( fabs (t - 1.0) < 1.0e-6 ) )
+      continue ;
+    U.setTZero (0.5 * z) ;
+    V.setTZero (0.5 * z) ;
+    U.set (utc, XTime::UTC, XTime::SECS) ;
+    V.setNanos (llround (utc * 1.0e9), XTime::UTC) ;
+    if ( fabs (V.getMET () - U.getMET ()) > 1.0e-6 ) {
+      snprintf (what, sizeof (what), "UTC %.6f setNanos, time zero %g s", utc, 0.5 * z) ;
+      snprintf (got, sizeof (got), "MET %.6f", V.getMET ()) ;
+      snprintf (expect, sizeof (expect), "MET %.6f", U.getMET ()) ;
+      fail (U.getMET (), what, got, expect) ;
+    }
+  }
+}
+
+//
+//   ---------
+// -- measure --
+//   ---------
+//
+
+// Description:
+// Time op() over all times t of one class, best of benchReps runs,
+// and report the cost per call.
+template <class Op>
+static void measure (const char *name, const char *path, const std::vector<double> &t, Op op)
+{
+  if ( benchPattern && !strstr (name, benchPattern) )
+    return ;
+  if ( t.empty () )
+    return ;
+
+  long n = t.size () ;
+  double best = 0.0 ;
+  double counts[BENCH_NCOUNTERS] = {0.0} ;
+  for (int r=-1; r<benchReps; r++) {
+    if ( benchNumCounters && ( r >= 0 ) )
+      benchCountersStart () ;
+    double t0 = benchNow () ;
+    double sum = 0.0 ;
+    for (long i=0; i<n; i++)
+      sum += op (i) ;
+    double dt = benchNow () - t0 ;
+    if ( benchNumCounters && ( r >= 0 ) )
+      benchCountersStop (counts) ;
+    benchSink = benchSink + sum ;
+    if ( ( r == 0 ) || ( ( r > 0 ) && ( dt < best ) ) )
+      best = dt ;
+  }
+
+  double ns = best / n ;
+  char extra[512] ;
+  printf ("%-44s %10.1f ns/op", name, ns) ;
+  snprintf (extra, sizeof (extra), "\"path\": \"%s\", \"times\": %ld", path, n) ;
+  if ( benchNumCounters )
+    benchCountersReport (counts, (double) n * benchReps, extra, sizeof (extra)) ;
+  printf ("\n") ;
+  fflush (stdout) ;
+  benchRecord (name, ns, extra) ;
+}
+
+int main (int argc, char **argv)
+{
+  benchArgs (argc, argv, 250) ;
+  double step = benchNops * 1.0e-6 ;
+  if ( ( step <= 0.0 ) || ( step > 1.0 ) ) {
+    fprintf (stderr, "%s: step must be 1 - 1000000 us\n", argv[0]) ;
+    return 1 ;
+  }
+
+  XTime T ;
+  const long *leapmjd ;
+  int nleaps = T.leapDates (&leapmjd) ;
+  long nstep = (long) ( 4.0 / step + 0.5 ) ;
+
+//  Sweep and verify; sort the times by path
+  std::vector<double> inside, outside ;
+  for (int l=1; l<nleaps; l++) {
+    // The leap second is the last second before leapmjd (UTC)
+    double end = XTime (leapmjd[l], 0.0, XTime::UTC, XTime::MJD).getMET () ;
+    double utcend = ( leapmjd[l] - MJDREF ) * 86400.0 ;
+    std::string last ;
+    long nsixty = 0 ;
+    for (long i=0; i<=nstep; i++) {
+      double met = end - 3.0 + i * step ;
+      if ( verify (met) ) {
+	inside.push_back (met) ;
+	nsixty++ ;
+      }
+      else
+	outside.push_back (met) ;
+      verifyNanos (utcend - 3.0 + i * step, utcend) ;
+      T.set (met) ;
+      std::string date = T.getDate (XTime::UTC, XTime::DATE, DEC) ;
+      if ( i && ( date <= last ) )
+	fail (met, "UTC DATE order", date.c_str (), last.c_str ()) ;
+      last = date ;
+    }
+    if ( labs (nsixty - (long) ( 1.0 / step + 0.5 )) > 1 ) {
+      char got[32], expect[32] ;
+      snprintf (got, sizeof (got), "%ld times", nsixty) ;
+      snprintf (expect, sizeof (expect), "%.0f", 1.0 / step) ;
+      fail (end - 1.0, "second 60", got, expect) ;
+    }
+  }
+  printf ("Leap second sweep: %d leap seconds, +-2 s in %g us steps: %ld times inside, %ld outside\n",
+	  nleaps - 1, step * 1.0e6, (long) inside.size (), (long) outside.size ()) ;
+  printf ("Round trips: %ld failure(s)\n", nfail) ;
+
+//  Cost per path
+  char name[64] ;
+  std::vector<std::string> date[2] ;
+  std::vector<double> *times[2] = {&outside, &inside} ;
+  const char *path[2] = {"outside", "inside"} ;
+  for (int p=0; p<2; p++)
+    for (size_t i=0; i<times[p]->size (); i++) {
+      T.set ((*times[p])[i]) ;
+      date[p].push_back (T.getDate (XTime::UTC, XTime::DATE, 3)) ;
+    }
+
+  for (int p=0; p<2; p++) {
+    std::vector<double> &t = *times[p] ;
+    snprintf (name, sizeof (name), "set MET (%s)", path[p]) ;
+    measure (name, path[p], t, [&] (long i) {
+	T.set (t[i]) ;
+	return T.getTT () ; }) ;
+    for (int tf=XTime::DATE; tf<=XTime::FITS; tf++) {
+      snprintf (name, sizeof (name), "set MET + getDate UTC %s (%s)", FORMNAME[tf], path[p]) ;
+      measure (name, path[p], t, [&] (long i) {
+	  T.set (t[i]) ;
+	  return (double) T.getDate (XTime::UTC, (XTime::TimeFormat) tf, 3)[18] ; }) ;
+    }
+    snprintf (name, sizeof (name), "set UTC DATE (%s)", path[p]) ;
+    std::vector<std::string> &d = date[p] ;
+    measure (name, path[p], t, [&] (long i) {
+	T.set (d[i].c_str (), XTime::UTC, XTime::DATE) ;
+	return T.getTT () ; }) ;
+    snprintf (name, sizeof (name), "UTC DATE round trip (%s)", path[p]) ;
+    measure (name, path[p], t, [&] (long i) {
+	T.set (d[i].c_str (), XTime::UTC, XTime::DATE) ;
+	return (double) T.getDate (XTime::UTC, XTime::DATE, 3)[18] ; }) ;
+  }
+
+  return nfail ? 1 : 0 ;
+}
@@ -0,0 +1,219 @@
+//----------------------------------------------------------------------
+//
+// File Name   : leapload_bench.cc
+// Subsystem   : XFF benchmarks
+// Description : Leap seconds file loading: fscanf loop against scanner
+//
+// .SECTION DESCRIPTION
+// Compares two ways of loading a tai-utc.dat file:
+//   fscanf   the loop XTime used up to now: fscanf with a format of
+//            several skipped fields per line, into arrays of 100
+//            entries (later entries are dropped), no checks
+//   scanner  XTime::readLeaps: the whole file read into one buffer
+//            and parsed by a hand-written scanner (parseLeaps), with
+//            every line and the order of the dates checked, into a
+//            table of any length
+// on two files written to a temporary directory: "small", the built-in
+// leap seconds (as the USNO file has them), and "large", nlines
+// entries.  Both loaders must give the same entries (up to 100 for
+// fscanf); the exit status is 1 if they do not.  The time per load
+// (including opening and reading the file) is the ns_per_op; the
+// time per line is an extra field.
+//
+// Usage: leapload_bench [-n nlines] [-r reps] [-j file] [-c] [pattern]
+//   nlines  Entries in the large file (default 10000)
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <vector>
+#include "XTime.h"
+#include "bench.h"
+
+static const int FSCANFMAX = 100 ;     // Capacity of the fscanf loader
+static const double MINTIME = 0.05 ;   // Minimum time per timed run (s)
+
+//
+//   ------------
+// -- fscanfLoad --
+//   ------------
+//
+
+// Description:
+// Load file the way XTime did before readLeaps, into mjd and secs (of
+// FSCANFMAX entries); return the number of entries, 0 if the file
+// cannot be opened.
+static int fscanfLoad (const char *file, long *mjd, double *secs)
+{
+  FILE *FF = fopen (file, "r") ;
+  if ( FF == NULL )
+    return 0 ;
+  long leapsMD ;
+  double leapsecs ;
+  int i ;
+  int nums = 0 ;
+  while ( fscanf (FF, "%d %*s  1 =JD 24%ld.5 %*s %lg S + (MJD - %*g) X %*g %*s",
+		  &i, &leapsMD, &leapsecs) == 3 ) {
+    if ( ( i > 1970 ) && ( nums < FSCANFMAX ) ) {
+      mjd[nums] = leapsMD ;
+      secs[nums] = leapsecs ;
+      nums++ ;
+    }
+  }
+  fclose (FF) ;
+  return nums ;
+}
+
+//
+//   ---------------
+// -- writeLeapFile --
+//   ---------------
+//
+
+// Description:
+// Write file with the built-in leap seconds followed by extra more,
+// evenly spaced from 2028 on (yearly if there are few, closer if the
+// dates would otherwise pass MJD 99999, the last one with a JD of the
+// form 24nnnnn.5), in the format of the USNO file; return the number of
+// lines, or -1 if the file cannot be written.
+static int writeLeapFile (const char *file, int extra)
+{
+  FILE *FF = fopen (file, "w") ;
+  if ( FF == NULL )
+    return -1 ;
+
+  XTime t ;
+  const long *mjds ;
+  const double *secs ;
+  int n = t.leapDates (&mjds) ;
+  t.leapSecs (&secs) ;
+  long step = extra ? ( 99999 - 61771 ) / extra : 365 ;
+  if ( step > 365 )
+    step = 365 ;
+  if ( step < 1 )
+    return -1 ;
+  for (int i=0; i<n+extra; i++) {
+    long mjd = ( i < n ) ? mjds[i] : 61771 + step * (long) ( i - n ) ;
+    double tai = ( i < n ) ? secs[i] : secs[n-1] + 1 + ( i - n ) ;
+    XTime d (mjd, 0.0, XTime::UTC, XTime::MJD) ;
+    const char *cal = d.getDate (XTime::UTC, XTime::CALDATE) ;   // yyyyMondd at ...
+    fprintf (FF, " %.4s %c%c%c  1 =JD 24%ld.5  TAI-UTC=  %4.1f       S + (MJD - 41317.) X 0.0      S\n",
+	     cal, toupper (cal[4]), toupper (cal[5]), toupper (cal[6]), mjd, tai) ;
+  }
+  if ( fclose (FF) )
+    return -1 ;
+  return n + extra ;
+}
+
+//
+//   ---------
+// -- measure --
+//   ---------
+//
+
+// Description:
+// Time load() (one load of a file of lines lines), repeated for at
+// least MINTIME per run, best of benchReps runs, and report it.
+template <class Load>
+static void measure (const char *name, int lines, Load load)
+{
+  if ( benchPattern && !strstr (name, benchPattern) )
+    return ;
+
+  long k = 1 ;
+  double t0 = benchNow () ;
+  benchSink = benchSink + load () ;
+  double once = ( benchNow () - t0 ) * 1.0e-9 ;
+  if ( once < MINTIME )
+    k = (long) ( MINTIME / ( once > 1.0e-7 ? once : 1.0e-7 ) ) + 1 ;
+
+  double best = 0.0 ;
+  double counts[BENCH_NCOUNTERS] = {0.0} ;
+  for (int r=0; r<benchReps; r++) {
+    if ( benchNumCounters )
+      benchCountersStart () ;
+    t0 = benchNow () ;
+    double sum = 0.0 ;
+    for (long i=0; i<k; i++)
+      sum += load () ;
+    double dt = ( benchNow () - t0 ) / k ;
+    if ( benchNumCounters )
+      benchCountersStop (counts) ;
+    benchSink = benchSink + sum ;
+    if ( !r || ( dt < best ) )
+      best = dt ;
+  }
+
+  char extra[512] ;
+  printf ("%-24s %12.0f ns/load %10.1f ns/line", name, best, best / lines) ;
+  snprintf (extra, sizeof (extra), "\"lines\": %d, \"ns_per_line\": %.6g", lines, best / lines) ;
+  if ( benchNumCounters )
+    benchCountersReport (counts, (double) k * benchReps, extra, sizeof (extra)) ;
+  printf ("\n") ;
+  fflush (stdout) ;
+  benchRecord (name, best, extra) ;
+}
+
+int main (int argc, char **argv)
+{
+  benchArgs (argc, argv, 10000) ;
+  int nlarge = (int) benchNops ;
+
+  char dir[] = "/tmp/leapload_benchXXXXXX" ;
+  if ( !mkdtemp (dir) ) {
+    perror ("mkdtemp") ;
+    return 1 ;
+  }
+  const char *what[2] = {"small", "large"} ;
+  char file[2][256] ;
+  int lines[2] ;
+  int nfail = 0 ;
+  XTime T ;
+  const long *mjds ;
+  int nbuiltin = T.leapDates (&mjds) ;
+  for (int f=0; f<2; f++) {
+    snprintf (file[f], sizeof (file[f]), "%s/tai-utc-%s.dat", dir, what[f]) ;
+    lines[f] = writeLeapFile (file[f], f ? nlarge - nbuiltin : 0) ;
+    if ( lines[f] < 0 ) {
+      perror (file[f]) ;
+      return 1 ;
+    }
+  }
+  printf ("Leap seconds file loading: small %d lines, large %d lines\n", lines[0], lines[1]) ;
+
+//  Both loaders must agree
+  long mjd[FSCANFMAX] ;
+  double secs[FSCANFMAX] ;
+  XTimeLeapTable table ;
+  for (int f=0; f<2; f++) {
+    int nf = fscanfLoad (file[f], mjd, secs) ;
+    int ns = XTime::readLeaps (file[f], &table) ;
+    int ok = ( ns == lines[f] ) && ( nf == ( ns < FSCANFMAX ? ns : FSCANFMAX ) ) ;
+    for (int i=0; ok && ( i < nf ); i++)
+      ok = ( mjd[i] == table.mjd[i] ) && ( secs[i] == table.secs[i] ) ;
+    printf ("  %s: fscanf %d entries, scanner %d entries: %s\n", what[f], nf, ns,
+	    ok ? "same" : "DIFFERENT") ;
+    nfail += !ok ;
+  }
+
+//  Cost per load
+  char name[64] ;
+  for (int f=0; f<2; f++) {
+    snprintf (name, sizeof (name), "fscanf %s", what[f]) ;
+    measure (name, lines[f], [&] () {
+	return (double) fscanfLoad (file[f], mjd, secs) ; }) ;
+    snprintf (name, sizeof (name), "scanner %s", what[f]) ;
+    measure (name, lines[f], [&] () {
+	return (double) XTime::readLeaps (file[f], &table) ; }) ;
+  }
+
+  for (int f=0; f<2; f++)
+    unlink (file[f]) ;
+  rmdir (dir) ;
+  return nfail ? 1 : 0 ;
+}
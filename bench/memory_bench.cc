@@ -0,0 +1,272 @@
+//----------------------------------------------------------------------
+//
+// File Name   : memory_bench.cc
+// Subsystem   : XFF benchmarks
+// Description : Memory footprint of XTime, XTimeRange, and XTRList
+//
+// .SECTION DESCRIPTION
+// Reports what the time classes cost in memory, so that changes to
+// their layout can be judged by numbers:
+//   - the size of an XTime, XTimeRange, and XTRList object, against
+//     the 16 bytes (day number and fraction) that define a time;
+//   - for arrays of 10, 100, ... up to nmax XTime objects and lists
+//     of as many ranges (GTI-like: 600 s every 1000 s): the bytes
+//     per time value and per range as allocated on the heap (through
+//     the global operator new, including new[]'s array cookie) and
+//     as the growth of the resident set size (/proc/self/statm; only
+//     meaningful for the larger sizes, which get pages of their own),
+//     and XTRList::memoryUsed;
+//   - for isInRange queries spread uniformly over each list: the
+//     ranges examined and the bytes read per query
+//     (XTRList::scanLength and bytesTouched, in 64-byte cache lines),
+//     and the time per query.
+// The time per XTime constructed and per query are the ns_per_op of
+// the results; the memory figures are extra fields.
+//
+// Usage: memory_bench [-n nmax] [-r reps] [-j file] [-c] [pattern]
+//   nmax    Largest array and list size (default 100000)
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <new>
+#include "XTime.h"
+#include "bench.h"
+
+static const double T0 = 1.0e8 ;       // Start of the lists (MET)
+static const double PERIOD = 1000.0 ;  // Spacing of the ranges
+static const double LENGTH = 600.0 ;   // Length of the ranges
+static const double SCAN = 4.0e7 ;     // Ranges examined per timed run
+static const long BATCH = 100000 ;     // Maximum queries per timed run
+static const int LINE = 64 ;           // Cache line size
+
+//  Heap accounting through the global operator new and delete
+
+static long liveBytes = 0 ;            // Bytes currently allocated
+static const size_t HEADER = 16 ;      // Room for the size, keeping alignment
+
+// The scalar and array forms of new and delete all share these two,
+// kept out of line as in xtrlist_bench.
+__attribute__ ((noinline)) static void *countedAlloc (size_t size)
+{
+  size_t *p = (size_t *) malloc (size + HEADER) ;
+  if ( p == NULL )
+    throw std::bad_alloc () ;
+  *p = size ;
+  liveBytes += size ;
+  return (char *) p + HEADER ;
+}
+
+__attribute__ ((noinline)) static void countedFree (void *ptr)
+{
+  if ( ptr == NULL )
+    return ;
+  size_t *p = (size_t *) ((char *) ptr - HEADER) ;
+  liveBytes -= *p ;
+  free (p) ;
+}
+
+void *operator new (size_t size)
+{
+  return countedAlloc (size) ;
+}
+
+void *operator new[] (size_t size)
+{
+  return countedAlloc (size) ;
+}
+
+void operator delete (void *ptr) noexcept
+{
+  countedFree (ptr) ;
+}
+
+void operator delete[] (void *ptr) noexcept
+{
+  countedFree (ptr) ;
+}
+
+void operator delete (void *ptr, size_t) noexcept
+{
+  countedFree (ptr) ;
+}
+
+void operator delete[] (void *ptr, size_t) noexcept
+{
+  countedFree (ptr) ;
+}
+
+//
+//   ---------------
+// -- residentBytes --
+//   ---------------
+//
+
+// Description:
+// Return the resident set size of the process in bytes, or -1 if it
+// cannot be read.
+static long residentBytes (void)
+{
+  long pages = -1, resident = -1 ;
+  FILE *FF = fopen ("/proc/self/statm", "r") ;
+  if ( FF == NULL )
+    return -1 ;
+  int ok = ( fscanf (FF, "%ld %ld", &pages, &resident) == 2 ) ;
+  fclose (FF) ;
+  return ok ? resident * sysconf (_SC_PAGESIZE) : -1 ;
+}
+
+//
+//   -----------
+// -- makeList --
+//   -----------
+//
+
+// Description:
+// Return a list of n ranges of LENGTH seconds, one every PERIOD
+// seconds starting at T0.
+static XTRList *makeList (int n)
+{
+  double *tstart = new double[n] ;
+  double *tstop = new double[n] ;
+  for (int i=0; i<n; i++) {
+    tstart[i] = T0 + i * PERIOD ;
+    tstop[i] = tstart[i] + LENGTH ;
+  }
+  XTRList *list = new XTRList (tstart, tstop, n) ;
+  delete [] tstart ;
+  delete [] tstop ;
+  return list ;
+}
+
+//
+//   ---------
+// -- measure --
+//   ---------
+//
+
+// Description:
+// Return the time per call of op(i), i = 0 ... k-1, best of benchReps
+// runs, accumulating the hardware counts, if enabled, in counts.
+template <class Op>
+static double measure (long k, Op op, double *counts)
+{
+  double best = 0.0 ;
+  for (int r=0; r<benchReps; r++) {
+    double sum = 0.0 ;
+    if ( benchNumCounters )
+      benchCountersStart () ;
+    double t0 = benchNow () ;
+    for (long i=0; i<k; i++)
+      sum += op (i) ;
+    double t = ( benchNow () - t0 ) / k ;
+    if ( benchNumCounters )
+      benchCountersStop (counts) ;
+    benchSink = benchSink + sum ;
+    if ( !r || ( t < best ) )
+      best = t ;
+  }
+  return best ;
+}
+
+//
+//   --------
+// -- report --
+//   --------
+//
+
+// Description:
+// Finish the line printed for benchmark name with its hardware counts
+// per operation, if enabled, and record it; extra holds its memory
+// figures.
+static void report (const char *name, double ns, const double *counts, double ops,
+		    char *extra, size_t size)
+{
+  if ( benchNumCounters )
+    benchCountersReport (counts, ops, extra, size) ;
+  printf ("\n") ;
+  benchRecord (name, ns, extra) ;
+  fflush (stdout) ;
+}
+
+int main (int argc, char **argv)
+{
+  benchArgs (argc, argv, 100000) ;
+  printf ("Object sizes: XTime %d, XTimeRange %d, XTRList %d bytes; a time needs %d\n",
+	  (int) sizeof (XTime), (int) sizeof (XTimeRange), (int) sizeof (XTRList),
+	  (int) ( sizeof (long) + sizeof (double) )) ;
+  char extra[512] ;
+  snprintf (extra, sizeof (extra),
+	    "\"xtime_bytes\": %d, \"xtimerange_bytes\": %d, \"xtrlist_bytes\": %d",
+	    (int) sizeof (XTime), (int) sizeof (XTimeRange), (int) sizeof (XTRList)) ;
+  benchRecord ("sizes", 0.0, extra) ;
+
+  printf ("%-24s %16s %10s %10s %10s %10s %10s\n", "", "",
+	  "heap B/el", "rss B/el", "used B/el", "scanned", "touched B") ;
+  char name[64] ;
+  for (long size=10; size<=benchNops; size*=10) {
+    int n = (int) size ;
+    double counts[BENCH_NCOUNTERS] = {0.0} ;
+
+//  Time values
+    snprintf (name, sizeof (name), "XTime n=%d", n) ;
+    if ( !benchPattern || strstr (name, benchPattern) ) {
+      long heap0 = liveBytes ;
+      long rss0 = residentBytes () ;
+      XTime *times = new XTime[n] ;
+      long heap = liveBytes - heap0 ;
+      long rss = residentBytes () - rss0 ;
+      double ns = measure (n, [&] (long i) {
+	  times[i] = XTime (T0 + i * 0.25625) ;
+	  return times[i].getMET () ; }, counts) ;
+      delete [] times ;
+      snprintf (extra, sizeof (extra),
+		"\"size\": %d, \"heap_bytes_per_time\": %.6g, \"rss_bytes_per_time\": %.6g",
+		n, (double) heap / n, (double) rss / n) ;
+      printf ("%-24s %10.1f ns/op %10.1f %10.1f", name, ns, (double) heap / n, (double) rss / n) ;
+      report (name, ns, counts, (double) n * benchReps, extra, sizeof (extra)) ;
+    }
+
+//  Lists of ranges and queries
+    snprintf (name, sizeof (name), "isInRange n=%d", n) ;
+    if ( !benchPattern || strstr (name, benchPattern) ) {
+      long heap0 = liveBytes ;
+      long rss0 = residentBytes () ;
+      XTRList *list = makeList (n) ;
+      long heap = liveBytes - heap0 ;
+      long rss = residentBytes () - rss0 ;
+      long used = list->memoryUsed () ;
+
+      long k = (long) ( SCAN / n ) ;
+      k = ( k < 16 ) ? 16 : ( k > BATCH ) ? BATCH : k ;
+      double *query = new double[k] ;
+      double scanned = 0.0, touched = 0.0 ;
+      for (long i=0; i<k; i++) {
+	query[i] = T0 + ( (i * 7919) % (10 * n) ) * 0.1 * PERIOD + 300.0 ;
+	scanned += list->scanLength (query[i]) ;
+	touched += list->bytesTouched (query[i], LINE) ;
+      }
+      scanned /= k ;
+      touched /= k ;
+
+      double ns = measure (k, [&] (long i) {
+	  return (double) list->isInRange (query[i]) ; }, counts) ;
+      snprintf (extra, sizeof (extra),
+		"\"size\": %d, \"heap_bytes_per_range\": %.6g, \"rss_bytes_per_range\": %.6g, "
+		"\"used_bytes\": %ld, \"ranges_scanned\": %.6g, \"bytes_touched\": %.6g, "
+		"\"bytes_touched_per_range\": %.6g",
+		n, (double) heap / n, (double) rss / n, used, scanned, touched, touched / scanned) ;
+      printf ("%-24s %10.1f ns/op %10.1f %10.1f %10.1f %10.1f %10.0f", name, ns,
+	      (double) heap / n, (double) rss / n, (double) used / n, scanned, touched) ;
+      report (name, ns, counts, (double) k * benchReps, extra, sizeof (extra)) ;
+      delete [] query ;
+      delete list ;
+    }
+  }
+
+  return 0 ;
+}
@@ -0,0 +1,251 @@
+# Licensed under a 3-clause BSD style license - see LICENSE.rst
+"""
+Performance regression gate for the C++ and Python benchmarks.
+
+Runs the benchmark suites (the C++ ``bench/*_bench`` programs, built with
+``make``, and ``bench/bench_time.py`` for the Python interface) and compares
+every result with the baseline checked in as ``bench/baseline.json``::
+
+  python bench/regress.py                   # run all suites and compare
+  python bench/regress.py xtime_bench       # only the named suites
+  python bench/regress.py --update          # run and rewrite the baseline
+  python bench/regress.py --results DIR     # compare DIR/<suite>.json; run nothing
+
+The baseline holds, for each suite, the arguments it runs with (``args``)
+and ns per op by benchmark name (``results``).  A benchmark regresses when it
+is slower than the baseline by more than its tolerance (a fraction) and by
+more than ``min_ns``.  The default tolerance is the ``tolerance`` of the
+baseline file; ``tolerances`` maps ``suite/name`` patterns (shell-style
+wildcards) to other values, and the last pattern that matches wins.  Records
+with ``ns_per_op`` 0 or ``skipped`` true (benchmarks that were not run) are
+ignored, as are benchmarks missing on either side.
+Every suite runs with the arguments recorded for it in the baseline, so that
+the numbers are comparable; ``--update`` keeps the arguments and tolerances
+and replaces the results with the fastest of ``--runs`` runs.  A suite that
+shows regressions is run again up to ``--retries`` times, keeping the fastest
+time of every benchmark, so that a single noisy run does not fail the gate.
+The exit status is 1 if any benchmark regressed or a suite failed.
+
+Only ``make``, a C++ compiler and this Python are needed; nothing is
+downloaded.  The baseline numbers belong to the machine they were measured
+on: regenerate them with ``--update`` on the machine that runs the gate.
+"""
+import argparse
+import fnmatch
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+BASELINE = os.path.join(BENCH_DIR, 'baseline.json')
+PYTHON_SUITE = 'bench_time'
+
+# Arguments for suites that are not yet in the baseline
+DEFAULT_SUITES = {
+    'xtime_bench': ['-n', '200000', '-r', '5'],
+    'xtrlist_bench': ['-n', '10000', '-r', '5'],
+    'workload_bench': ['-n', '20000', '-r', '5'],
+    'leap_bench': ['-n', '2000', '-r', '5'],
+    'memory_bench': ['-n', '100000', '-r', '5'],
+    'leapload_bench': ['-n', '10000', '-r', '5'],
+    'startup_bench': ['-n', '20'],
+    PYTHON_SUITE: ['--max-size', '1e3', '--budget', '0.1', '--repeat', '3',
+                   '--min-time', '0.01'],
+}
+
+
+def run_suite(suite, args, outfile):
+    """
+    Run benchmark ``suite`` with ``args``, writing its JSON results to
+    ``outfile``.  Returns the exit status.
+    """
+    if suite == PYTHON_SUITE:
+        cmd = ([sys.executable, os.path.join(BENCH_DIR, 'bench_time.py')]
+               + args + ['--save', outfile])
+    else:
+        status = subprocess.call(['make', '-s', '-C', BENCH_DIR, suite])
+        if status:
+            return status
+        cmd = [os.path.join(BENCH_DIR, suite)] + args + ['-j', outfile]
+    print('Running {}'.format(' '.join(cmd)))
+    sys.stdout.flush()
+    with open(os.devnull, 'w') as devnull:
+        return subprocess.call(cmd, stdout=devnull)
+
+
+def get_results(filename):
+    """
+    Return a dict of ns per op by benchmark name from a benchmark JSON file,
+    leaving out the benchmarks that were not run.
+    """
+    with open(filename) as fh:
+        results = json.load(fh)['results']
+    return {res['name']: res['ns_per_op'] for res in results
+            if res.get('ns_per_op', 0) > 0 and not res.get('skipped', False)}
+
+
+def get_tolerance(baseline, suite, name):
+    """
+    Return the tolerance for benchmark ``name`` of ``suite``.
+    """
+    tolerance = baseline.get('tolerance', 0.25)
+    for pattern, value in baseline.get('tolerances', {}).items():
+        if fnmatch.fnmatchcase('{}/{}'.format(suite, name), pattern):
+            tolerance = value
+    return tolerance
+
+
+def compare(baseline, suite, results, quiet=False):
+    """
+    Compare the ``results`` of ``suite`` with the baseline and return the
+    names of the benchmarks that regressed; unless ``quiet``, print them and
+    the ones that got faster.
+    """
+    base = baseline['suites'][suite]['results']
+    min_ns = baseline.get('min_ns', 0.0)
+    regressed = []
+    compared = 0
+    for name, ns in results.items():
+        old = base.get(name)
+        if old is None:
+            continue
+        compared += 1
+        tolerance = get_tolerance(baseline, suite, name)
+        ratio = ns / old
+        if ratio > 1 + tolerance and ns - old > min_ns:
+            regressed.append(name)
+            if not quiet:
+                print('  REGRESSION {:56s} {:12.1f} -> {:12.1f} ns ({:+.0%}, tolerance {:.0%})'
+                      .format(name, old, ns, ratio - 1, tolerance))
+        elif ratio < 1 / (1 + tolerance) and old - ns > min_ns and not quiet:
+            print('  faster     {:56s} {:12.1f} -> {:12.1f} ns ({:+.0%})'
+                  .format(name, old, ns, ratio - 1))
+    if not quiet:
+        print('{}: compared {} benchmarks ({} new, {} not run): {} regressions'
+              .format(suite, compared, len(set(results) - set(base)),
+                      len(set(base) - set(results)), len(regressed)))
+    return regressed
+
+
+def measure(suite, args, outdir, results=None):
+    """
+    Run ``suite`` once and return ``results`` (a dict of ns per op by name)
+    updated with the fastest times, or None if the suite failed.
+    """
+    outfile = os.path.join(outdir, suite + '.json')
+    if run_suite(suite, args, outfile):
+        print('{}: FAILED'.format(suite))
+        return None
+    try:
+        new = get_results(outfile)
+    except (OSError, IOError, ValueError, KeyError) as err:
+        print('{}: no results ({})'.format(suite, err))
+        return None
+    if results is None:
+        return new
+    for name, ns in new.items():
+        results[name] = min(ns, results.get(name, ns))
+    return results
+
+
+def get_parser():
+    parser = argparse.ArgumentParser(
+        description='Compare the benchmarks with the checked-in baseline')
+    parser.add_argument('suites', nargs='*',
+                        help='Suites to run (default: all suites in the baseline)')
+    parser.add_argument('--baseline', default=BASELINE,
+                        help='Baseline JSON file (default=bench/baseline.json)')
+    parser.add_argument('--results',
+                        help='Compare the <suite>.json files in this directory '
+                        'instead of running the suites')
+    parser.add_argument('--update', action='store_true',
+                        help='Run the suites and write their results to the baseline')
+    parser.add_argument('--runs', type=int, default=3,
+                        help='With --update, runs per suite; the fastest time of each '
+                        'benchmark is saved (default=3)')
+    parser.add_argument('--retries', type=int, default=2,
+                        help='Runs of a suite again while it shows regressions, keeping '
+                        'the fastest time of each benchmark (default=2)')
+    return parser
+
+
+def main(args=None):
+    opt = get_parser().parse_args(args)
+    if os.path.exists(opt.baseline):
+        with open(opt.baseline) as fh:
+            baseline = json.load(fh)
+    elif opt.update:
+        baseline = {'tolerance': 0.3, 'min_ns': 2.0,
+                    'tolerances': {'startup_bench/*': 1.0, PYTHON_SUITE + '/*': 0.5},
+                    'suites': {}}
+    else:
+        print('No baseline {}; create it with --update'.format(opt.baseline))
+        return 1
+
+    suites = opt.suites or list(baseline['suites']) or list(DEFAULT_SUITES)
+    unknown = set(suites) - set(baseline['suites']) - set(DEFAULT_SUITES)
+    if unknown:
+        print('Unknown suites: {}'.format(', '.join(sorted(unknown))))
+        return 1
+
+    failed = []
+    regressions = 0
+    outdir = opt.results or tempfile.mkdtemp(prefix='bench_regress')
+    for suite in suites:
+        args = baseline['suites'].get(suite, {}).get('args', DEFAULT_SUITES.get(suite))
+        if opt.results:
+            try:
+                results = get_results(os.path.join(outdir, suite + '.json'))
+            except (OSError, IOError, ValueError, KeyError) as err:
+                print('{}: no results ({})'.format(suite, err))
+                results = None
+        else:
+            results = measure(suite, args, outdir)
+            runs = opt.runs if opt.update else 1
+            retries = 0 if opt.update else opt.retries
+            for run in range(1, runs + retries):
+                if results is None:
+                    break
+                if run >= runs:
+                    # A retry: only if something looks slower than the baseline
+                    if (suite not in baseline['suites']
+                            or not compare(baseline, suite, results, quiet=True)):
+                        break
+                    print('{}: regressions; running again'.format(suite))
+                results = measure(suite, args, outdir, results)
+        if results is None:
+            failed.append(suite)
+            continue
+
+        if opt.update:
+            baseline['suites'][suite] = {
+                'args': args,
+                'results': {name: float('{:.4g}'.format(ns)) for name, ns in results.items()}}
+            print('{}: {} benchmarks saved'.format(suite, len(results)))
+        elif suite in baseline['suites']:
+            regressions += len(compare(baseline, suite, results))
+        else:
+            print('{}: not in the baseline'.format(suite))
+
+    if opt.update:
+        baseline['machine'] = {'platform': platform.platform(),
+                               'processor': platform.processor() or platform.machine(),
+                               'python': platform.python_version()}
+        with open(opt.baseline, 'w') as fh:
+            json.dump(baseline, fh, indent=1)
+            fh.write('\n')
+    if not opt.results:
+        shutil.rmtree(outdir)
+    if failed:
+        print('Failed suites: {}'.format(', '.join(failed)))
+    if regressions:
+        print('{} regressions'.format(regressions))
+    return 1 if failed or regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,224 @@
+//----------------------------------------------------------------------
+//
+// File Name   : startup_bench.cc
+// Subsystem   : XFF benchmarks
+// Description : Cold and warm first-conversion latency of XTime
+//
+// .SECTION DESCRIPTION
+// Short-lived programs pay for loading the leap second table on their
+// first conversion.  This benchmark runs itself nruns times as a
+// fresh child process per scenario and measures in the child the
+// first conversion (MET seconds to UTC date, which loads the leap
+// seconds: cold) and a second one (warm), and in the parent the time
+// from fork to exit of the child.  The scenarios are:
+//   built-in     TIMING_DIR and ASC_DATA unset: built-in leap seconds
+//   TIMING_DIR   a tai-utc.dat, written from the built-in table with
+//                one more leap second, in a temporary TIMING_DIR (read
+//                and used)
+//   TIMING_DIR same  a tai-utc.dat with the built-in leap seconds: read
+//                but not used
+//   environment  TIMING_DIR and ASC_DATA as given (only if either
+//                is set)
+// The median over the runs is reported (with the minimum in the JSON
+// output), as well as where the child got its leap seconds, and how
+// long the lookup and read took (XTime::leapSource).
+//
+// Usage: startup_bench [-n nruns] [-j file] [pattern]
+//   nruns   Child processes per scenario (default 20)
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <vector>
+#include "XTime.h"
+#include "bench.h"
+
+static const double MET = 6.0e8 ;      // Time converted (2017)
+
+//
+//   -------
+// -- child --
+//   -------
+//
+
+// Description:
+// Time the first and second conversion and print them, with the
+// leap second source, on one line.
+static int child (void)
+{
+  double t0 = benchNow () ;
+  XTime T (MET) ;
+  char c = T.getDate (XTime::UTC, XTime::DATE, 3)[0] ;
+  double t1 = benchNow () ;
+  XTime T2 (MET + 1.0) ;
+  c += T2.getDate (XTime::UTC, XTime::DATE, 3)[0] ;
+  double t2 = benchNow () ;
+  benchSink = benchSink + c ;
+
+  const char *file ;
+  double readtime ;
+  int fallback ;
+  int nleaps = T.leapSource (&file, &readtime, &fallback) ;
+  printf ("%.0f %.0f %.0f %d %d %s\n", t1 - t0, t2 - t1, readtime * 1.0e9,
+	  nleaps, fallback, file) ;
+  return 0 ;
+}
+
+//
+//   ---------------
+// -- writeLeapFile --
+//   ---------------
+//
+
+// Description:
+// Write the built-in leap seconds to dir/tai-utc.dat, in the format
+// of the USNO file, followed by one for 2028 Jan 1 if extra is set;
+// return 0 on success.
+static int writeLeapFile (const char *dir, int extra)
+{
+  char path[256] ;
+  snprintf (path, sizeof (path), "%s/tai-utc.dat", dir) ;
+  FILE *FF = fopen (path, "w") ;
+  if ( FF == NULL )
+    return 1 ;
+
+  XTime t ;
+  const long *mjds ;
+  const double *secs ;
+  int n = t.leapDates (&mjds) ;
+  t.leapSecs (&secs) ;
+  for (int i=0; i<n; i++) {
+    XTime d (mjds[i], 0.0, XTime::UTC, XTime::MJD) ;
+    const char *cal = d.getDate (XTime::UTC, XTime::CALDATE) ;   // yyyyMondd at ...
+    fprintf (FF, " %.4s %c%c%c  1 =JD 24%ld.5  TAI-UTC=  %4.1f       S + (MJD - 41317.) X 0.0      S\n",
+	     cal, toupper (cal[4]), toupper (cal[5]), toupper (cal[6]), mjds[i], secs[i]) ;
+  }
+  if ( extra )
+    fprintf (FF, " 2028 JAN  1 =JD 2461771.5  TAI-UTC=  %4.1f       S + (MJD - 41317.) X 0.0      S\n",
+	     secs[n-1] + 1.0) ;
+  return fclose (FF) ? 1 : 0 ;
+}
+
+//
+//   ----------
+// -- scenario --
+//   ----------
+//
+
+// Description:
+// Run the child nruns times with TIMING_DIR and ASC_DATA set to
+// timing and ascdata (unset if NULL) and report the medians.
+static void scenario (const char *name, const char *exe, const char *timing, const char *ascdata)
+{
+  if ( benchPattern && !strstr (name, benchPattern) )
+    return ;
+
+  std::vector<double> cold, warm, proc, read ;
+  int nleaps = 0 ;
+  int fallback = 0 ;
+  char file[256] = "" ;
+
+  for (long r=0; r<benchNops; r++) {
+    int fd[2] ;
+    if ( pipe (fd) ) {
+      perror ("pipe") ;
+      exit (1) ;
+    }
+    double t0 = benchNow () ;
+    pid_t pid = fork () ;
+    if ( pid < 0 ) {
+      perror ("fork") ;
+      exit (1) ;
+    }
+    if ( pid == 0 ) {
+      timing ? setenv ("TIMING_DIR", timing, 1) : unsetenv ("TIMING_DIR") ;
+      ascdata ? setenv ("ASC_DATA", ascdata, 1) : unsetenv ("ASC_DATA") ;
+      dup2 (fd[1], 1) ;
+      close (fd[0]) ;
+      close (fd[1]) ;
+      execl (exe, exe, "-child", (char *) NULL) ;
+      _exit (127) ;
+    }
+    close (fd[1]) ;
+    char line[512] = "" ;
+    FILE *FP = fdopen (fd[0], "r") ;
+    if ( !fgets (line, sizeof (line), FP) )
+      line[0] = 0 ;
+    fclose (FP) ;
+    int status ;
+    waitpid (pid, &status, 0) ;
+    proc.push_back (benchNow () - t0) ;
+
+    double c, w, rt ;
+    file[0] = 0 ;
+    if ( sscanf (line, "%lg %lg %lg %d %d %255s", &c, &w, &rt, &nleaps, &fallback, file) < 5 ) {
+      fprintf (stderr, "%s: child failed\n", name) ;
+      return ;
+    }
+    cold.push_back (c) ;
+    warm.push_back (w) ;
+    read.push_back (rt) ;
+  }
+
+  printf ("%s: %d leap seconds from %s\n", name, nleaps, fallback ? "the built-in table" : file) ;
+  const char *what[4] = {"first conversion", "second conversion", "leap file lookup+read", "process"} ;
+  std::vector<double> *data[4] = {&cold, &warm, &read, &proc} ;
+  for (int k=0; k<4; k++) {
+    std::vector<double> &v = *data[k] ;
+    std::sort (v.begin (), v.end ()) ;
+    double median = v[v.size () / 2] ;
+    char label[128] ;
+    char extra[512] ;
+    snprintf (label, sizeof (label), "%s (%s)", what[k], name) ;
+    printf ("  %-40s %12.0f ns median %12.0f ns min\n", label, median, v[0]) ;
+    snprintf (extra, sizeof (extra),
+	      "\"scenario\": \"%s\", \"min_ns\": %.6g, \"runs\": %ld, \"leap_seconds\": %d, "
+	      "\"fallback\": %s, \"file\": \"%s\"",
+	      name, v[0], benchNops, nleaps, fallback ? "true" : "false", file) ;
+    benchRecord (label, median, extra) ;
+  }
+  fflush (stdout) ;
+}
+
+int main (int argc, char **argv)
+{
+  if ( ( argc == 2 ) && !strcmp (argv[1], "-child") )
+    return child () ;
+
+  benchArgs (argc, argv, 20) ;
+  printf ("XTime startup benchmarks: %ld child processes per scenario\n", benchNops) ;
+
+  char dir[] = "/tmp/startup_benchXXXXXX" ;
+  char samedir[] = "/tmp/startup_benchXXXXXX" ;
+  if ( !mkdtemp (dir) || writeLeapFile (dir, 1) ) {
+    perror (dir) ;
+    return 1 ;
+  }
+  if ( !mkdtemp (samedir) || writeLeapFile (samedir, 0) ) {
+    perror (samedir) ;
+    return 1 ;
+  }
+
+  const char *timing = getenv ("TIMING_DIR") ;
+  const char *ascdata = getenv ("ASC_DATA") ;
+  scenario ("built-in", argv[0], NULL, NULL) ;
+  scenario ("TIMING_DIR", argv[0], dir, NULL) ;
+  scenario ("TIMING_DIR same", argv[0], samedir, NULL) ;
+  if ( timing || ascdata )
+    scenario ("environment", argv[0], timing, ascdata) ;
+
+  char path[256] ;
+  const char *dirs[2] = {dir, samedir} ;
+  for (int i=0; i<2; i++) {
+    snprintf (path, sizeof (path), "%s/tai-utc.dat", dirs[i]) ;
+    unlink (path) ;
+    rmdir (dirs[i]) ;
+  }
+  return 0 ;
+}
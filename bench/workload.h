@@ -0,0 +1,196 @@
+//----------------------------------------------------------------------
+//
+// File Name   : workload.h
+// Subsystem   : XFF benchmarks
+// Description : Synthetic Chandra-like workloads for the benchmarks
+//
+// .SECTION DESCRIPTION
+// Deterministic (seeded) generators of the kinds of input the time
+// library sees in production:
+//   metStream   Monotonic telemetry MET time stamps at a fixed cadence
+//               (CADENCE: 0.25625 s minor frames, 1.025 s, 32.8 s
+//               major frames), with clock jitter and occasional
+//               telemetry dropouts
+//   eventList   Photon event times with Poisson arrivals
+//   gtiList     Good time intervals: log-normal good intervals,
+//               mostly short gaps, and now and then a long one (radiation
+//               belt passage)
+//   dateCorpus  Date strings in a mix of formats and precisions, with
+//               a fraction of them inside or next to leap seconds
+// All times are MET seconds (TT since 1998.0).
+//
+//----------------------------------------------------------------------
+//
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "XTime.h"
+
+static const int NCADENCE = 3 ;
+static const double CADENCE[NCADENCE] = {0.25625, 1.025, 32.8} ;
+static const double WORKLOAD_T0 = 5.0e8 ;    // Start of the workloads (2013)
+
+//
+//   ---------
+// -- WorkRng --
+//   ---------
+//
+
+// Description:
+// Small deterministic random number generator (xorshift64)
+class WorkRng {
+  unsigned long long state ;
+ public:
+  WorkRng (unsigned long long seed) : state (seed * 2654435761ULL + 88172645463325252ULL) { }
+  double uniform (void) {              // [0, 1)
+    state ^= state << 13 ;
+    state ^= state >> 7 ;
+    state ^= state << 17 ;
+    return ( state >> 11 ) * ( 1.0 / 9007199254740992.0 ) ; }
+  double exponential (double mean) {
+    return -mean * log (1.0 - uniform ()) ; }
+  double normal (void) {               // Box-Muller
+    return sqrt (-2.0 * log (1.0 - uniform ())) * cos (6.283185307179586 * uniform ()) ; }
+} ;
+
+//
+//   -----------
+// -- metStream --
+//   -----------
+//
+
+// Description:
+// Return n telemetry time stamps at cadence seconds, starting at t0,
+// with 1 us rms jitter and a dropout of up to an hour with
+// probability 1e-4 per frame.
+inline std::vector<double> metStream (double cadence, long n, unsigned long long seed,
+				      double t0=WORKLOAD_T0)
+{
+  WorkRng rng (seed) ;
+  std::vector<double> t (n) ;
+  double next = t0 ;
+  for (long i=0; i<n; i++) {
+    if ( rng.uniform () < 1.0e-4 )
+      next += cadence * floor (rng.uniform () * 3600.0 / cadence) ;
+    t[i] = next + 1.0e-6 * rng.normal () ;
+    if ( i && ( t[i] <= t[i-1] ) )
+      t[i] = t[i-1] + 1.0e-6 ;
+    next += cadence ;
+  }
+  return t ;
+}
+
+//
+//   -----------
+// -- eventList --
+//   -----------
+//
+
+// Description:
+// Return n event times with Poisson arrivals at rate (per s),
+// starting at t0.
+inline std::vector<double> eventList (double rate, long n, unsigned long long seed,
+				      double t0=WORKLOAD_T0)
+{
+  WorkRng rng (seed) ;
+  std::vector<double> t (n) ;
+  double next = t0 ;
+  for (long i=0; i<n; i++) {
+    next += rng.exponential (1.0 / rate) ;
+    t[i] = next ;
+  }
+  return t ;
+}
+
+//
+//   ---------
+// -- gtiList --
+//   ---------
+//
+
+// Description:
+// Fill tstart and tstop with n good time intervals from t0 on:
+// good intervals log-normal around 3 ks (a factor 3 spread), gaps
+// exponential with a mean of 30 s, except that one in twenty is a
+// 10 - 60 ks belt passage.
+inline void gtiList (long n, unsigned long long seed, std::vector<double> &tstart,
+		     std::vector<double> &tstop, double t0=WORKLOAD_T0)
+{
+  WorkRng rng (seed) ;
+  tstart.resize (n) ;
+  tstop.resize (n) ;
+  double t = t0 ;
+  for (long i=0; i<n; i++) {
+    tstart[i] = t ;
+    t += 3000.0 * exp (log (3.0) * rng.normal ()) ;
+    tstop[i] = t ;
+    if ( rng.uniform () < 0.05 )
+      t += 10000.0 + 50000.0 * rng.uniform () ;
+    else
+      t += 1.0 + rng.exponential (30.0) ;
+  }
+}
+
+//
+//   -----------
+// -- DateInput --
+//   -----------
+//
+
+// Description:
+// One date string with its format
+struct DateInput {
+  XTime::TimeFormat tf ;               // DATE, CALDATE, or FITS
+  char code[4] ;                       // axTime3 format code
+  std::string date ;                   // UTC date string
+} ;
+
+//
+//   ------------
+// -- dateCorpus --
+//   ------------
+//
+
+// Description:
+// Return n UTC date strings: half DATE, a quarter each CALDATE and
+// FITS, with 0 - 6 decimals (mostly 3), for times from 1999 through
+// 2030; a fraction leapfrac of them falls within a second of a leap
+// second (a third of those inside it).
+inline std::vector<DateInput> dateCorpus (long n, double leapfrac, unsigned long long seed)
+{
+  static const char *const formCode = "dcf" ;
+  WorkRng rng (seed) ;
+  XTime T ;
+  const long *leapmjd ;
+  int nleaps = T.leapDates (&leapmjd) ;
+  double met1999 = XTime (51179L, 0.0, XTime::UTC, XTime::MJD).getMET () ;
+  double met2031 = XTime (62867L, 0.0, XTime::UTC, XTime::MJD).getMET () ;
+  std::vector<DateInput> corpus (n) ;
+
+  for (long i=0; i<n; i++) {
+    double u = rng.uniform () ;
+    int f = ( u < 0.5 ) ? 0 : ( u < 0.75 ) ? 1 : 2 ;
+    u = rng.uniform () ;
+    int dec = ( u < 0.7 ) ? 3 : (int) ( rng.uniform () * 7.0 ) ;
+    double met ;
+    if ( rng.uniform () < leapfrac ) {
+      // The leap second is the last second before leapmjd (UTC)
+      long mjd = leapmjd[1 + (long) ( rng.uniform () * (nleaps - 1) )] ;
+      double end = XTime (mjd, 0.0, XTime::UTC, XTime::MJD).getMET () ;
+      met = end - 1.0 + ( rng.uniform () * 3.0 - 1.0 ) ;
+    }
+    else
+      met = met1999 + rng.uniform () * (met2031 - met1999) ;
+    T.set (met) ;
+    corpus[i].tf = (XTime::TimeFormat) (XTime::DATE + f) ;
+    snprintf (corpus[i].code, sizeof (corpus[i].code), "%c%d", formCode[f], dec) ;
+    corpus[i].date = T.getDate (XTime::UTC, corpus[i].tf, dec) ;
+  }
+  return corpus ;
+}
+
+#endif
@@ -0,0 +1,216 @@
+//----------------------------------------------------------------------
+//
+// File Name   : workload_bench.cc
+// Subsystem   : XFF benchmarks
+// Description : Replay of synthetic production workloads
+//
+// .SECTION DESCRIPTION
+// Generates the workloads of workload.h and replays them through
+// XTime, axTime3 (one call per time, and the batch _convert_buffer),
+// and XTRList, reporting the throughput in items per second:
+//   telemetry   MET stamps at each cadence to UTC date (decommutation)
+//   events      Poisson event times to UTC MJD and TT JD, UTC MJD back
+//               to TT MJD, and screening with the GTI list (isInRange)
+//   dates       Mixed-format date string corpus (1% around leap
+//               seconds) to MET
+//   gti         Building the GTI list, intersecting it with a second
+//               one, and merging in flare intervals (orRange)
+// Each replay is a full pass over its workload, best of reps runs.
+//
+// Usage: workload_bench [-n nitems] [-r reps] [-j file] [-c] [pattern]
+//   nitems  Times per workload (default 100000); the GTI lists have
+//           nitems/500 intervals
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include <string.h>
+#include "XTime.h"
+#include "axTime3.h"
+#include "bench.h"
+#include "workload.h"
+
+static const double EVENTRATE = 20.0 ;  // Events per second
+static const double LEAPFRAC = 0.01 ;   // Dates around leap seconds
+
+//
+//   --------
+// -- replay --
+//   --------
+//
+
+// Description:
+// Time op(), which processes n items and returns a checksum, and
+// report the best time per item and the throughput.
+template <class Op>
+static void replay (const char *name, const char *workload, long n, Op op)
+{
+  if ( benchPattern && !strstr (name, benchPattern) )
+    return ;
+
+  double best = 0.0 ;
+  double counts[BENCH_NCOUNTERS] = {0.0} ;
+  for (int r=-1; r<benchReps; r++) {
+    if ( benchNumCounters && ( r >= 0 ) )
+      benchCountersStart () ;
+    double t0 = benchNow () ;
+    double sum = op () ;
+    double t = benchNow () - t0 ;
+    if ( benchNumCounters && ( r >= 0 ) )
+      benchCountersStop (counts) ;
+    benchSink = benchSink + sum ;
+    if ( ( r == 0 ) || ( ( r > 0 ) && ( t < best ) ) )
+      best = t ;
+  }
+
+  double ns = best / n ;
+  char extra[512] ;
+  printf ("%-44s %10.1f ns/item %12.0f items/s", name, ns, 1.0e9 / ns) ;
+  snprintf (extra, sizeof (extra), "\"workload\": \"%s\", \"items\": %ld", workload, n) ;
+  if ( benchNumCounters )
+    benchCountersReport (counts, (double) n * benchReps, extra, sizeof (extra)) ;
+  printf ("\n") ;
+  fflush (stdout) ;
+  benchRecord (name, ns, extra) ;
+}
+
+int main (int argc, char **argv)
+{
+  char name[64] ;
+  char wname[32] ;
+
+  benchArgs (argc, argv, 100000) ;
+  long n = benchNops ;
+  long ngti = ( n / 500 > 2 ) ? n / 500 : 2 ;
+
+  std::vector<double> met[NCADENCE] ;
+  for (int c=0; c<NCADENCE; c++)
+    met[c] = metStream (CADENCE[c], n, 1 + c) ;
+  std::vector<double> events = eventList (EVENTRATE, n, 11) ;
+  std::vector<double> gtistart, gtistop, gti2start, gti2stop ;
+  gtiList (ngti, 21, gtistart, gtistop) ;
+  gtiList (ngti, 22, gti2start, gti2stop) ;
+  std::vector<DateInput> dates = dateCorpus (n, LEAPFRAC, 31) ;
+
+  // Fixed-width buffers for _convert_buffer
+  const int WIDTH = 32 ;
+  std::vector<char> datebuf (n * WIDTH, 0), outbuf (n * WIDTH, 0) ;
+  std::vector<double> numout (n) ;
+  for (long i=0; i<n; i++)
+    strncpy (&datebuf[i * WIDTH], dates[i].date.c_str (), WIDTH) ;
+
+  printf ("Workload replay: %ld items per workload, %ld GTIs, %d runs\n", n, ngti, benchReps) ;
+
+  XTime T ;
+  char in[64], out[80] ;
+  char sysm[] = "m", sysu[] = "u", syst[] = "t", forms[] = "s", formd[] = "d3", formm[] = "m",
+    formj[] = "j" ;
+
+//  Telemetry: MET to UTC date
+  for (int c=0; c<NCADENCE; c++) {
+    std::vector<double> &t = met[c] ;
+    snprintf (wname, sizeof (wname), "telemetry %gs", CADENCE[c]) ;
+    snprintf (name, sizeof (name), "XTime %s MET->date", wname) ;
+    replay (name, wname, n, [&] () {
+	double sum = 0.0 ;
+	for (long i=0; i<n; i++) {
+	  T.set (t[i]) ;
+	  sum += T.getDate (XTime::UTC, XTime::DATE, 3)[20] ;
+	}
+	return sum ; }) ;
+    snprintf (name, sizeof (name), "axTime3 %s MET->date", wname) ;
+    replay (name, wname, n, [&] () {
+	double sum = 0.0 ;
+	for (long i=0; i<n; i++) {
+	  snprintf (in, sizeof (in), "%.6f", t[i]) ;
+	  _convert_time (in, sysm, forms, sysu, formd, out) ;
+	  sum += out[20] ;
+	}
+	return sum ; }) ;
+    snprintf (name, sizeof (name), "_convert_buffer %s MET->date", wname) ;
+    replay (name, wname, n, [&] () {
+	_convert_buffer (&t[0], NULL, 0, 0, n, sysm, forms, sysu, formd,
+			 NULL, &outbuf[0], WIDTH, 1, NULL) ;
+	return (double) outbuf[20] ; }) ;
+  }
+
+//  Events: MET to UTC MJD and TT JD, MJD to MJD, and GTI screening
+  replay ("XTime events MET->UTC MJD", "events", n, [&] () {
+      double sum = 0.0 ;
+      for (long i=0; i<n; i++) {
+	T.set (events[i]) ;
+	sum += T.get (XTime::UTC, XTime::MJD) ;
+      }
+      return sum ; }) ;
+  replay ("_convert_buffer events MET->UTC MJD", "events", n, [&] () {
+      _convert_buffer (&events[0], NULL, 0, 0, n, sysm, forms, sysu, formm,
+		       &numout[0], NULL, 0, 0, NULL) ;
+      return numout[n-1] ; }) ;
+  replay ("_convert_buffer events MET->TT JD", "events", n, [&] () {
+      _convert_buffer (&events[0], NULL, 0, 0, n, sysm, forms, syst, formj,
+		       &numout[0], NULL, 0, 0, NULL) ;
+      return numout[n-1] ; }) ;
+  std::vector<double> eventmjd (n) ;
+  _convert_buffer (&events[0], NULL, 0, 0, n, sysm, forms, sysu, formm,
+		   &eventmjd[0], NULL, 0, 0, NULL) ;
+  replay ("_convert_buffer events UTC MJD->TT MJD", "events", n, [&] () {
+      _convert_buffer (&eventmjd[0], NULL, 0, 0, n, sysu, formm, syst, formm,
+		       &numout[0], NULL, 0, 0, NULL) ;
+      return numout[n-1] ; }) ;
+  XTRList gti (&gtistart[0], &gtistop[0], (int) ngti) ;
+  replay ("XTRList events isInRange", "events", n, [&] () {
+      double sum = 0.0 ;
+      for (long i=0; i<n; i++)
+	sum += gti.isInRange (events[i]) ;
+      return sum ; }) ;
+
+//  Date strings to MET
+  replay ("XTime dates->MET", "dates", n, [&] () {
+      double sum = 0.0 ;
+      for (long i=0; i<n; i++) {
+	T.set (dates[i].date.c_str (), XTime::UTC, dates[i].tf) ;
+	sum += T.getMET () ;
+      }
+      return sum ; }) ;
+  replay ("axTime3 dates->MET", "dates", n, [&] () {
+      double sum = 0.0 ;
+      for (long i=0; i<n; i++) {
+	strcpy (in, dates[i].date.c_str ()) ;
+	_convert_time (in, sysu, dates[i].code, sysm, forms, out) ;
+	sum += out[0] ;
+      }
+      return sum ; }) ;
+  // _convert_buffer takes one format per call: replay the DATE strings
+  long ndate = 0 ;
+  std::vector<char> date1buf ;
+  for (long i=0; i<n; i++)
+    if ( dates[i].tf == XTime::DATE ) {
+      date1buf.insert (date1buf.end (), &datebuf[i * WIDTH], &datebuf[(i + 1) * WIDTH]) ;
+      ndate++ ;
+    }
+  replay ("_convert_buffer DATE dates->MET", "dates", ndate, [&] () {
+      _convert_buffer (NULL, &date1buf[0], WIDTH, 1, ndate, sysu, formd, sysm, forms,
+		       &numout[0], NULL, 0, 0, NULL) ;
+      return numout[0] ; }) ;
+
+//  GTI list operations
+  replay ("XTRList build GTI list", "gti", ngti, [&] () {
+      XTRList l (&gtistart[0], &gtistop[0], (int) ngti) ;
+      return (double) l.getNumXTRs () ; }) ;
+  XTRList gti2 (&gti2start[0], &gti2stop[0], (int) ngti) ;
+  replay ("XTRList AND of two GTI lists", "gti", ngti, [&] () {
+      XTRList l (gti, gti2) ;
+      return (double) l.getNumXTRs () ; }) ;
+  replay ("XTRList orRange flares", "gti", ngti, [&] () {
+      XTRList l (gti) ;
+      WorkRng rng (41) ;
+      double span = gtistop[ngti-1] - gtistart[0] ;
+      for (long i=0; i<ngti/10+1; i++) {
+	double t = gtistart[0] + rng.uniform () * span ;
+	l.orRange (XTimeRange (t, t + 100.0 + rng.exponential (500.0))) ;
+      }
+      return (double) l.getNumXTRs () ; }) ;
+
+  return 0 ;
+}
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------
+//
+// File Name   : workload_gen.cc
+// Subsystem   : XFF benchmarks
+// Description : Write the synthetic workloads of workload.h to files
+//
+// .SECTION DESCRIPTION
+// Writes the workloads replayed by workload_bench as text files in
+// directory dir, for use by other tools (e.g. the Python
+// benchmarks), one item per line:
+//   met_0.25625.txt, met_1.025.txt, met_32.8.txt   MET seconds
+//   events.txt                                     MET seconds
+//   gti.txt                                        tstart tstop
+//   dates.txt                                      axTime3 format code, date
+//
+// Usage: workload_gen [-n nitems] [-s seed] dir
+//   nitems  Times per workload (default 100000); the GTI list has
+//           nitems/500 intervals
+//   seed    Added to the seeds of the generators (default 0)
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "workload.h"
+
+//
+//   -----------
+// -- openFile --
+//   -----------
+//
+
+// Description:
+// Open dir/name for writing; exit on failure.
+static FILE *openFile (const char *dir, const char *name)
+{
+  char path[512] ;
+  snprintf (path, sizeof (path), "%s/%s", dir, name) ;
+  FILE *FF = fopen (path, "w") ;
+  if ( FF == NULL ) {
+    perror (path) ;
+    exit (1) ;
+  }
+  return FF ;
+}
+
+int main (int argc, char **argv)
+{
+  long n = 100000 ;
+  unsigned long long seed = 0 ;
+  const char *dir = NULL ;
+
+  for (int i=1; i<argc; i++) {
+    if ( !strcmp (argv[i], "-n") && ( i+1 < argc ) )
+      n = atol (argv[++i]) ;
+    else if ( !strcmp (argv[i], "-s") && ( i+1 < argc ) )
+      seed = strtoull (argv[++i], NULL, 10) ;
+    else if ( ( argv[i][0] != '-' ) && !dir )
+      dir = argv[i] ;
+    else
+      dir = NULL, argc = 0 ;
+  }
+  if ( !dir || ( n < 1 ) ) {
+    fprintf (stderr, "Usage: %s [-n nitems] [-s seed] dir\n", argv[0]) ;
+    return 1 ;
+  }
+
+  char name[64] ;
+  for (int c=0; c<NCADENCE; c++) {
+    std::vector<double> t = metStream (CADENCE[c], n, seed + 1 + c) ;
+    snprintf (name, sizeof (name), "met_%g.txt", CADENCE[c]) ;
+    FILE *FF = openFile (dir, name) ;
+    for (long i=0; i<n; i++)
+      fprintf (FF, "%.6f\n", t[i]) ;
+    fclose (FF) ;
+  }
+
+  std::vector<double> events = eventList (20.0, n, seed + 11) ;
+  FILE *FF = openFile (dir, "events.txt") ;
+  for (long i=0; i<n; i++)
+    fprintf (FF, "%.6f\n", events[i]) ;
+  fclose (FF) ;
+
+  std::vector<double> tstart, tstop ;
+  long ngti = ( n / 500 > 2 ) ? n / 500 : 2 ;
+  gtiList (ngti, seed + 21, tstart, tstop) ;
+  FF = openFile (dir, "gti.txt") ;
+  for (long i=0; i<ngti; i++)
+    fprintf (FF, "%.6f %.6f\n", tstart[i], tstop[i]) ;
+  fclose (FF) ;
+
+  std::vector<DateInput> dates = dateCorpus (n, 0.01, seed + 31) ;
+  FF = openFile (dir, "dates.txt") ;
+  for (long i=0; i<n; i++)
+    fprintf (FF, "%s %s\n", dates[i].code, dates[i].date.c_str ()) ;
+  fclose (FF) ;
+
+  printf ("Wrote %ld times per workload and %ld GTIs to %s\n", n, ngti, dir) ;
+  return 0 ;
+}
@@ -0,0 +1,243 @@
+//----------------------------------------------------------------------
+//
+// File Name   : xtime_bench.cc
+// Subsystem   : XFF benchmarks
+// Description : Microbenchmarks for XTime set/get/getDate
+//
+// .SECTION DESCRIPTION
+// Times the XTime set overloads (numeric, long+double, and date
+// string), get for every TimeSys and numeric TimeFormat, getDate
+// for DATE, CALDATE, and FITS at 0 through 9 decimals, UTmjd, and
+// the leap second lookup (setmyleaps, through setTZero, which calls
+// nothing else), and MET <-> UTC seconds per time and in batches
+// (XTime::convertSecs), and the same in integer nanoseconds
+// (setNanos/getNanos and XTime::convertNanos), and double-double JD
+// and seconds (getHiLo).  The inputs are NIN times from 1972 through 2039,
+// half uniformly spread and half within one day of a leap second,
+// where the lookup and the date formatting take their slow paths.
+//
+// Usage: xtime_bench [-n nops] [-r reps] [-j file] [-c] [pattern]
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include "XTime.h"
+#include "bench.h"
+
+static const int NIN = 4096 ;          // Number of inputs (power of 2)
+static const long MJD1972 = 41317 ;    // MJD at 1972.0
+static const long MJD2040 = 66154 ;    // MJD at 2040.0
+
+static double metIn[NIN] ;             // MET seconds
+static long mjdiIn[4][NIN] ;           // MJD (integer part) per TimeSys
+static double mjdfIn[4][NIN] ;         // MJD (fractional part) per TimeSys
+static double secsIn[4][NIN] ;         // Seconds per TimeSys
+static char dateIn[3][NIN][32] ;       // UTC DATE, CALDATE, FITS strings
+static XTime timeIn[NIN] ;             // Times as XTime objects
+
+static const char *sysName[4] = {"MET", "TT", "UTC", "TAI"} ;
+static const char *formName[6] = {"SECS", "JD", "MJD", "DATE", "CALDATE", "FITS"} ;
+
+//
+//   ---------
+// -- uniform --
+//   ---------
+//
+
+// Description:
+// Return a deterministic pseudo-random number in [0, 1)
+static double uniform (void)
+{
+  static unsigned long long state = 88172645463325252ULL ;
+  state ^= state << 13 ;
+  state ^= state >> 7 ;
+  state ^= state << 17 ;
+  return ( state >> 11 ) * ( 1.0 / 9007199254740992.0 ) ;
+}
+
+//
+//   ------------
+// -- makeInputs --
+//   ------------
+//
+
+// Description:
+// Fill the input tables; return the number of leap seconds.
+static int makeInputs (void)
+{
+  XTime t ;
+  const long *leapmjd ;
+  int nleaps = t.leapDates (&leapmjd) ;
+  double met1972 = XTime (MJD1972, 0.0, XTime::UTC, XTime::MJD).getMET () ;
+  double met2040 = XTime (MJD2040, 0.0, XTime::UTC, XTime::MJD).getMET () ;
+
+  for (int i=0; i<NIN; i++) {
+    if ( i % 2 )
+      metIn[i] = met1972 + uniform () * (met2040 - met1972) ;
+    else {
+      // Within one day of a leap second (skipping 1972.0 itself)
+      long mjd = leapmjd[1 + (i / 2) % (nleaps - 1)] ;
+      metIn[i] = XTime (mjd, 0.0, XTime::UTC, XTime::MJD).getMET ()
+	+ ( 2.0 * uniform () - 1.0 ) * 86400.0 ;
+    }
+    timeIn[i].set (metIn[i]) ;
+    for (int s=0; s<4; s++) {
+      XTime::TimeSys ts = (XTime::TimeSys) s ;
+      secsIn[s][i] = timeIn[i].get (ts, XTime::SECS) ;
+      if ( ts == XTime::UTC )
+	timeIn[i].UTmjd (mjdiIn[s]+i, mjdfIn[s]+i) ;
+      else if ( ts == XTime::TAI )
+	timeIn[i].TAImjd (mjdiIn[s]+i, mjdfIn[s]+i) ;
+      else
+	timeIn[i].TTmjd (mjdiIn[s]+i, mjdfIn[s]+i) ;
+    }
+    for (int f=0; f<3; f++)
+      strcpy (dateIn[f][i], timeIn[i].getDate (XTime::UTC, (XTime::TimeFormat) (f + XTime::DATE), 3)) ;
+  }
+  return nleaps ;
+}
+
+int main (int argc, char **argv)
+{
+  char name[64] ;
+
+  benchArgs (argc, argv, 200000) ;
+  int nleaps = makeInputs () ;
+  printf ("XTime benchmarks: %d inputs 1972-2039 (half near %d leap seconds), %ld ops x %d runs\n",
+	  NIN, nleaps, benchNops, benchReps) ;
+
+  XTime T ;
+
+//  set (double tt, TimeSys ts, TimeFormat tf)
+  for (int s=0; s<4; s++)
+    for (int f=0; f<3; f++) {
+      XTime::TimeSys ts = (XTime::TimeSys) s ;
+      XTime::TimeFormat tf = (XTime::TimeFormat) f ;
+      const double *in = tf == XTime::SECS ? secsIn[s] : mjdfIn[s] ;
+      const long *inti = mjdiIn[s] ;
+      double offset = tf == XTime::JD ? 2400000.5 : 0.0 ;
+      snprintf (name, sizeof (name), "set(double) %s %s", sysName[s], formName[f]) ;
+      benchRun (name, [&] (long i) {
+	  int k = i & (NIN - 1) ;
+	  T.set (tf == XTime::SECS ? in[k] : inti[k] + in[k] + offset, ts, tf) ;
+	  return T.getMET () ; }) ;
+    }
+
+//  set (long tti, double ttf, TimeSys ts, TimeFormat tf)
+  for (int s=0; s<4; s++)
+    for (int f=1; f<3; f++) {
+      XTime::TimeSys ts = (XTime::TimeSys) s ;
+      XTime::TimeFormat tf = (XTime::TimeFormat) f ;
+      const long *inti = mjdiIn[s] ;
+      const double *inf = mjdfIn[s] ;
+      long offset = tf == XTime::JD ? 2400000 : 0 ;
+      double offsetf = tf == XTime::JD ? 0.5 : 0.0 ;
+      snprintf (name, sizeof (name), "set(long,double) %s %s", sysName[s], formName[f]) ;
+      benchRun (name, [&] (long i) {
+	  int k = i & (NIN - 1) ;
+	  T.set (inti[k] + offset, inf[k] + offsetf, ts, tf) ;
+	  return T.getMET () ; }) ;
+    }
+
+//  set (const char* date, TimeSys ts, TimeFormat tf)
+  for (int f=0; f<3; f++) {
+    XTime::TimeFormat tf = (XTime::TimeFormat) (f + XTime::DATE) ;
+    char (*in)[32] = dateIn[f] ;
+    snprintf (name, sizeof (name), "set(char*) UTC %s", formName[tf]) ;
+    benchRun (name, [&] (long i) {
+	T.set (in[i & (NIN - 1)], XTime::UTC, tf) ;
+	return T.getMET () ; }) ;
+  }
+
+//  get (TimeSys ts, TimeFormat tf)
+  for (int s=0; s<4; s++)
+    for (int f=0; f<3; f++) {
+      XTime::TimeSys ts = (XTime::TimeSys) s ;
+      XTime::TimeFormat tf = (XTime::TimeFormat) f ;
+      snprintf (name, sizeof (name), "get %s %s", sysName[s], formName[f]) ;
+      benchRun (name, [&] (long i) {
+	  return timeIn[i & (NIN - 1)].get (ts, tf) ; }) ;
+    }
+
+//  getHiLo (double *lo, TimeSys ts, TimeFormat tf)
+  for (int s=1; s<3; s++)
+    for (int f=0; f<2; f++) {
+      XTime::TimeSys ts = (XTime::TimeSys) s ;
+      XTime::TimeFormat tf = (XTime::TimeFormat) f ;
+      snprintf (name, sizeof (name), "getHiLo %s %s", sysName[s], formName[f]) ;
+      benchRun (name, [&] (long i) {
+	  double lo ;
+	  double hi = timeIn[i & (NIN - 1)].getHiLo (&lo, ts, tf) ;
+	  return hi + 1e6 * lo ; }) ;
+    }
+
+//  getDate (TimeSys ts, TimeFormat tf, int dec)
+  for (int f=0; f<3; f++)
+    for (int dec=0; dec<10; dec++) {
+      XTime::TimeFormat tf = (XTime::TimeFormat) (f + XTime::DATE) ;
+      snprintf (name, sizeof (name), "getDate UTC %s dec=%d", formName[tf], dec) ;
+      benchRun (name, [&] (long i) {
+	  return (double) timeIn[i & (NIN - 1)].getDate (XTime::UTC, tf, dec)[dec] ; }) ;
+    }
+
+//  UTmjd
+  benchRun ("UTmjd", [&] (long i) {
+      return timeIn[i & (NIN - 1)].UTmjd () ; }) ;
+  benchRun ("UTmjd(long*,double*)", [&] (long i) {
+      long mjdi ;
+      double mjdf ;
+      timeIn[i & (NIN - 1)].UTmjd (&mjdi, &mjdf) ;
+      return mjdi + mjdf ; }) ;
+
+//  setmyleaps (through setTZero)
+  benchRun ("setmyleaps", [&] (long i) {
+      XTime &t = timeIn[i & (NIN - 1)] ;
+      t.setTZero (0.0) ;
+      return t.UTmjd () ; }) ;
+
+//  Seconds between MET and UTC: one time at a time, and in batches of
+//  NIN by the UTC offset segments (convertSecs)
+  static double secsOut[NIN] ;
+  for (int s=0; s<3; s+=2) {
+    XTime::TimeSys tsIn = (XTime::TimeSys) s ;
+    XTime::TimeSys tsOut = s ? XTime::MET : XTime::UTC ;
+    const double *in = secsIn[s] ;
+    snprintf (name, sizeof (name), "set+get %s SECS -> %s SECS", sysName[s], sysName[tsOut]) ;
+    benchRun (name, [&] (long i) {
+	T.set (in[i & (NIN - 1)], tsIn, XTime::SECS) ;
+	return T.get (tsOut, XTime::SECS) ; }) ;
+    snprintf (name, sizeof (name), "convertSecs %s -> %s", sysName[s], sysName[tsOut]) ;
+    benchRun (name, [&] (long i) {
+	int k = i & (NIN - 1) ;
+	if ( !k )
+	  XTime::convertSecs (in, secsOut, NIN, tsOut == XTime::UTC) ;
+	return secsOut[k] ; }) ;
+  }
+
+//  The same in integer nanoseconds
+  static long long nanosIn[3][NIN] ;
+  static long long nanosOut[NIN] ;
+  for (int i=0; i<NIN; i++) {
+    T.set (secsIn[0][i], XTime::MET, XTime::SECS) ;
+    nanosIn[0][i] = T.getNanos (XTime::MET) ;
+    nanosIn[2][i] = T.getNanos (XTime::UTC) ;
+  }
+  for (int s=0; s<3; s+=2) {
+    XTime::TimeSys tsIn = (XTime::TimeSys) s ;
+    XTime::TimeSys tsOut = s ? XTime::MET : XTime::UTC ;
+    const long long *in = nanosIn[s] ;
+    snprintf (name, sizeof (name), "setNanos+getNanos %s -> %s", sysName[s], sysName[tsOut]) ;
+    benchRun (name, [&] (long i) {
+	T.setNanos (in[i & (NIN - 1)], tsIn) ;
+	return (double) T.getNanos (tsOut) ; }) ;
+    snprintf (name, sizeof (name), "convertNanos %s -> %s", sysName[s], sysName[tsOut]) ;
+    benchRun (name, [&] (long i) {
+	int k = i & (NIN - 1) ;
+	if ( !k )
+	  XTime::convertNanos (in, nanosOut, NIN, tsOut == XTime::UTC) ;
+	return (double) nanosOut[k] ; }) ;
+  }
+
+  return 0 ;
+}
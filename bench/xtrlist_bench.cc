@@ -0,0 +1,369 @@
+//----------------------------------------------------------------------
+//
+// File Name   : xtrlist_bench.cc
+// Subsystem   : XFF benchmarks
+// Description : Scaling benchmark for XTRList operations
+//
+// .SECTION DESCRIPTION
+// Times XTRList orRange, andRange, orList, the AND constructor,
+// notList, isInRange, getRange, and totalTime on lists of 10, 100,
+// ... up to nmax time ranges, and counts the heap allocations, bytes
+// allocated, and peak heap use per operation.  The lists look like
+// GTIs: ranges of 600 s every 1000 s, and for orList and the AND
+// constructor a second list of 300 s ranges offset by 500 s.
+// Some of these operations are quadratic in the list size, so the
+// time per operation at the next size is predicted from the growth
+// between the previous sizes; that sets the number of operations per
+// timed run (about BATCHTIME seconds' worth, at most BATCH ranges'
+// worth of list copies), and a size is skipped for an operation if
+// one operation would take more than BUDGET seconds.
+//
+// Usage: xtrlist_bench [-n nmax] [-r reps] [-j file] [-c] [pattern]
+//   nmax    Largest list size (default 1000000)
+//
+//----------------------------------------------------------------------
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <sys/resource.h>
+#include "XTime.h"
+#include "bench.h"
+
+static const double BUDGET = 1.0 ;     // Seconds allowed for one operation
+static const double BATCHTIME = 0.2 ;  // Seconds per timed run
+static const long BATCH = 100000 ;     // Ranges copied per timed run
+static const double T0 = 1.0e8 ;       // Start of the lists (MET)
+static const double PERIOD = 1000.0 ;  // Spacing of the ranges
+static const double LENGTH = 600.0 ;   // Length of the ranges
+
+//  Heap accounting through the global operator new and delete
+
+static long allocCount = 0 ;           // Number of allocations
+static long allocBytes = 0 ;           // Bytes allocated
+static long liveBytes = 0 ;            // Bytes currently allocated
+static long peakBytes = 0 ;            // Maximum of liveBytes
+static const size_t HEADER = 16 ;      // Room for the size, keeping alignment
+
+// The scalar and array forms of new and delete all share these two,
+// which are kept out of line so that the compiler does not pair the
+// malloc and free here with the new and delete expressions.
+__attribute__ ((noinline)) static void *countedAlloc (size_t size)
+{
+  size_t *p = (size_t *) malloc (size + HEADER) ;
+  if ( p == NULL )
+    throw std::bad_alloc () ;
+  *p = size ;
+  allocCount++ ;
+  allocBytes += size ;
+  liveBytes += size ;
+  if ( liveBytes > peakBytes )
+    peakBytes = liveBytes ;
+  return (char *) p + HEADER ;
+}
+
+__attribute__ ((noinline)) static void countedFree (void *ptr)
+{
+  if ( ptr == NULL )
+    return ;
+  size_t *p = (size_t *) ((char *) ptr - HEADER) ;
+  liveBytes -= *p ;
+  free (p) ;
+}
+
+void *operator new (size_t size)
+{
+  return countedAlloc (size) ;
+}
+
+void *operator new[] (size_t size)
+{
+  return countedAlloc (size) ;
+}
+
+void operator delete (void *ptr) noexcept
+{
+  countedFree (ptr) ;
+}
+
+void operator delete[] (void *ptr) noexcept
+{
+  countedFree (ptr) ;
+}
+
+void operator delete (void *ptr, size_t) noexcept
+{
+  countedFree (ptr) ;
+}
+
+void operator delete[] (void *ptr, size_t) noexcept
+{
+  countedFree (ptr) ;
+}
+
+//
+//   -----------
+// -- makeList --
+//   -----------
+//
+
+// Description:
+// Return a list of n ranges of length len, one every PERIOD
+// seconds starting at T0+offset.
+static XTRList *makeList (int n, double offset, double len)
+{
+  double *tstart = new double[n] ;
+  double *tstop = new double[n] ;
+  for (int i=0; i<n; i++) {
+    tstart[i] = T0 + offset + i * PERIOD ;
+    tstop[i] = tstart[i] + len ;
+  }
+  XTRList *list = new XTRList (tstart, tstop, n) ;
+  delete [] tstart ;
+  delete [] tstop ;
+  return list ;
+}
+
+//
+//   ---------
+// -- Measure --
+//   ---------
+//
+
+// Description:
+// Per operation results of one benchmark at one list size
+struct Measure {
+  double ns ;                          // Time
+  double allocs ;                      // Allocations
+  double bytes ;                       // Bytes allocated
+  long peak ;                          // Peak heap use above the start
+  double ops ;                         // Operations in all timed runs
+  double counts[BENCH_NCOUNTERS] ;     // Hardware counts (over all runs)
+} ;
+
+//
+//   ---------
+// -- measure --
+//   ---------
+//
+
+// Description:
+// Run op(k, i) for i = 0 ... k-1 (best of benchReps timed runs);
+// setup(k) is called untimed before each run to prepare k inputs
+// and cleanup(k) afterwards.  The peak heap use is that of a single
+// operation, in an extra untimed run.  Hardware counts, if enabled,
+// cover the timed runs only.
+template <class Setup, class Op, class Cleanup>
+static Measure measure (long k, Setup setup, Op op, Cleanup cleanup)
+{
+  Measure m = {0.0, 0.0, 0.0, 0, (double) k * benchReps, {0.0}} ;
+  for (int r=0; r<benchReps; r++) {
+    setup (k) ;
+    long count0 = allocCount ;
+    long bytes0 = allocBytes ;
+    double sum = 0.0 ;
+    if ( benchNumCounters )
+      benchCountersStart () ;
+    double t0 = benchNow () ;
+    for (long i=0; i<k; i++)
+      sum += op (k, i) ;
+    double t = ( benchNow () - t0 ) / k ;
+    if ( benchNumCounters )
+      benchCountersStop (m.counts) ;
+    benchSink = benchSink + sum ;
+    if ( !r || ( t < m.ns ) )
+      m.ns = t ;
+    m.allocs = (double) (allocCount - count0) / k ;
+    m.bytes = (double) (allocBytes - bytes0) / k ;
+    cleanup (k) ;
+  }
+
+  setup (1) ;
+  long live0 = liveBytes ;
+  peakBytes = liveBytes ;
+  benchSink = benchSink + op (1, 0) ;
+  m.peak = peakBytes - live0 ;
+  cleanup (1) ;
+  return m ;
+}
+
+//
+//   --------
+// -- report --
+//   --------
+//
+
+// Description:
+// Print and record the result of benchmark op at list size n;
+// a NULL m means the size was skipped.
+static void report (const char *op, int n, const Measure *m)
+{
+  char name[64] ;
+  char extra[512] ;
+
+  snprintf (name, sizeof (name), "%s n=%d", op, n) ;
+  if ( m == NULL ) {
+    printf ("%-28s %12s\n", name, "skipped") ;
+    snprintf (extra, sizeof (extra), "\"op\": \"%s\", \"size\": %d, \"skipped\": true", op, n) ;
+    benchRecord (name, 0.0, extra) ;
+    return ;
+  }
+  printf ("%-28s %12.1f ns/op %10.1f allocs %12.0f bytes %12ld peak",
+	  name, m->ns, m->allocs, m->bytes, m->peak) ;
+  snprintf (extra, sizeof (extra),
+	    "\"op\": \"%s\", \"size\": %d, \"allocs_per_op\": %.6g, "
+	    "\"bytes_per_op\": %.6g, \"peak_bytes\": %ld",
+	    op, n, m->allocs, m->bytes, m->peak) ;
+  if ( benchNumCounters )
+    benchCountersReport (m->counts, m->ops, extra, sizeof (extra)) ;
+  printf ("\n") ;
+  benchRecord (name, m->ns, extra) ;
+  fflush (stdout) ;
+}
+
+//
+//   -----
+// -- Run --
+//   -----
+//
+
+// Description:
+// Bookkeeping for the time budget of one operation
+struct Run {
+  const char *op ;                     // Operation name
+  double lastns ;                      // Time at the previous size
+  double growth ;                      // Time ratio between the last two sizes
+  int skip ;                           // Skip the remaining sizes
+} ;
+
+//
+//   ------
+// -- wants --
+//   ------
+//
+
+// Description:
+// Return the number of operations per timed run (at most kmax) if
+// run should be measured at this size, or 0; report it as skipped
+// if it is over budget.
+static long wants (Run *run, int n, long kmax)
+{
+  if ( benchPattern && !strstr (run->op, benchPattern) )
+    return 0 ;
+  double ns = run->lastns * run->growth ;
+  if ( !run->skip && ( ns > BUDGET * 1.0e9 ) )
+    run->skip = 1 ;
+  if ( run->skip ) {
+    report (run->op, n, NULL) ;
+    return 0 ;
+  }
+  long k = ( ns > 0.0 ) ? (long) ( BATCHTIME * 1.0e9 / ns ) : kmax ;
+  return ( k < 1 ) ? 1 : ( k > kmax ) ? kmax : k ;
+}
+
+//
+//   ------
+// -- done --
+//   ------
+//
+
+// Description:
+// Report the result of run and update its budget estimate.
+static void done (Run *run, int n, const Measure &m)
+{
+  report (run->op, n, &m) ;
+  if ( run->lastns > 0.0 )
+    run->growth = m.ns / run->lastns ;
+  run->lastns = m.ns ;
+}
+
+int main (int argc, char **argv)
+{
+  enum {OR_RANGE, AND_RANGE, OR_LIST, AND_LISTS, NOT_LIST,
+	IS_IN_RANGE, GET_RANGE, TOTAL_TIME, NUM_OPS} ;
+  Run runs[NUM_OPS] = {
+    {"orRange", 0.0, 10.0, 0}, {"andRange", 0.0, 10.0, 0},
+    {"orList", 0.0, 10.0, 0}, {"XTRList(and)", 0.0, 10.0, 0},
+    {"notList", 0.0, 10.0, 0}, {"isInRange", 0.0, 10.0, 0},
+    {"getRange", 0.0, 10.0, 0}, {"totalTime", 0.0, 10.0, 0}} ;
+
+  benchArgs (argc, argv, 1000000) ;
+  printf ("XTRList benchmarks: sizes 10 - %ld, %d runs, budget %g s per operation\n",
+	  benchNops, benchReps, BUDGET) ;
+
+  for (long size=10; size<=benchNops; size*=10) {
+    int n = (int) size ;
+    XTRList *list = makeList (n, 0.0, LENGTH) ;
+    XTRList *other = makeList (n, 500.0, 300.0) ;
+    long kcopy = ( BATCH / n > 1 ) ? BATCH / n : 1 ;
+    XTRList **work = new XTRList*[kcopy] ;
+    double mid = T0 + (n / 2) * PERIOD ;
+    double span = n * PERIOD ;
+    XTimeRange gap (mid + 700.0, mid + 800.0) ;
+    XTimeRange half (T0 + 0.25 * span, T0 + 0.75 * span) ;
+    XTimeRange all (T0 - PERIOD, T0 + span + PERIOD) ;
+    long k ;
+
+    auto copies = [&] (long k) {
+      for (long i=0; i<k; i++)
+	work[i] = new XTRList (*list) ; } ;
+    auto nothing = [&] (long) { } ;
+    auto release = [&] (long k) {
+      for (long i=0; i<k; i++)
+	delete work[i] ; } ;
+    auto query = [&] (long i) {
+      return T0 + ( (i * 7919) % (10 * n) ) * 0.1 * PERIOD + 300.0 ; } ;
+
+    if ( ( k = wants (runs+OR_RANGE, n, kcopy) ) )
+      done (runs+OR_RANGE, n, measure (k, copies, [&] (long, long i) {
+	    work[i]->orRange (gap) ;
+	    return (double) work[i]->getNumXTRs () ; }, release)) ;
+
+    if ( ( k = wants (runs+AND_RANGE, n, kcopy) ) )
+      done (runs+AND_RANGE, n, measure (k, copies, [&] (long, long i) {
+	    work[i]->andRange (half) ;
+	    return (double) work[i]->getNumXTRs () ; }, release)) ;
+
+    if ( ( k = wants (runs+OR_LIST, n, kcopy) ) )
+      done (runs+OR_LIST, n, measure (k, copies, [&] (long, long i) {
+	    work[i]->orList (*other) ;
+	    return (double) work[i]->getNumXTRs () ; }, release)) ;
+
+    if ( ( k = wants (runs+AND_LISTS, n, kcopy) ) )
+      done (runs+AND_LISTS, n, measure (k, nothing, [&] (long, long i) {
+	    work[i] = new XTRList (*list, *other) ;
+	    return (double) work[i]->getNumXTRs () ; }, release)) ;
+
+    if ( ( k = wants (runs+NOT_LIST, n, kcopy) ) )
+      done (runs+NOT_LIST, n, measure (k, copies, [&] (long, long i) {
+	    work[i]->notList (all) ;
+	    return (double) work[i]->getNumXTRs () ; }, release)) ;
+
+    if ( ( k = wants (runs+IS_IN_RANGE, n, BATCH) ) )
+      done (runs+IS_IN_RANGE, n, measure (k, nothing, [&] (long, long i) {
+	    return (double) list->isInRange (query (i)) ; }, nothing)) ;
+
+    if ( ( k = wants (runs+GET_RANGE, n, BATCH) ) )
+      done (runs+GET_RANGE, n, measure (k, nothing, [&] (long, long i) {
+	    const XTimeRange *r = list->getRange (query (i)) ;
+	    return r ? r->METStart () : 0.0 ; }, nothing)) ;
+
+    if ( ( k = wants (runs+TOTAL_TIME, n, BATCH) ) )
+      done (runs+TOTAL_TIME, n, measure (k, nothing, [&] (long, long) {
+	    return list->totalTime () ; }, nothing)) ;
+
+    delete [] work ;
+    delete list ;
+    delete other ;
+  }
+
+  struct rusage usage ;
+  getrusage (RUSAGE_SELF, &usage) ;
+  printf ("Maximum resident set size: %ld kB\n", usage.ru_maxrss) ;
+  char extra[64] ;
+  snprintf (extra, sizeof (extra), "\"max_rss_kb\": %ld", usage.ru_maxrss) ;
+  benchRecord ("process", 0.0, extra) ;
+
+  return 0 ;
+}
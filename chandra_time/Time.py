@@ -360,7 +360,7 @@ def frac_year_to_secs(frac_year):
 
 
 def secs_to_frac_year(secs):
-    year = int(DateTime(secs).date[:4])
+    year = int(DateTime(secs, format='secs').date[:4])
     s0, s1 = _year_secs.setdefault(year, year_start_end_secs(year))
     return (float(secs) - s0) / (s1 - s0) + year
 
@@ -491,6 +491,9 @@ time_styles = [TimeStyle(name='fits',
                          ),
                ]
 
+# Formats that convert_vals() can produce directly (styles with a dtype)
+FAST_FORMATS = set(time_style.name for time_style in time_styles if time_style.dtype)
+
 time_system = {'met': 'm',  # MET     Mission Elapsed Time ("m")
                'tt': 't',  # TT      Terrestrial Time ("t")
                'tai': 'a',  # TAI     International Atomic Time ("ta" or "a")
@@ -526,12 +529,14 @@ def _make_array(val):
     return val, val_ndim
 
 
-def convert_vals(vals, format_in, format_out):
+def convert_vals(vals, format_in, format_out, return_valid=False, context=None):
     """
     Convert ``vals`` from the input ``format_in`` to the output format
-    ``format_out``.  This does **no input validation** and thus runs much faster
-    than the corresponding DateTime() conversion.  Be careful because invalid
-    inputs can give unpredictable results.
+    ``format_out``.  This runs much faster than the corresponding DateTime()
+    conversion because the format is not guessed.  Each input is validated
+    natively while it is converted (finite number, or string with the syntax
+    of ``format_in``), and a ``ValueError`` giving the indices of invalid
+    inputs is raised unless ``return_valid`` is True.
 
     The input ``vals`` can be a single (scalar) value, a Python list or a numpy
     array.  The output data type is specified with ``dtype`` which must be a
@@ -541,11 +546,18 @@ def convert_vals(vals, format_in, format_out):
     format names: 'secs', 'date', 'jd', 'mjd', 'fits', 'caldate'.
 
     The function returns the converted time as either a scalar or a numpy
-    array, depending on the input ``vals``.
+    array, depending on the input ``vals``.  With ``return_valid=True`` it
+    returns a tuple of the converted time and a boolean validity flag of the
+    same shape, and invalid inputs give NaN or an empty string.
+
+    With ``context`` (see ``time_context``) the conversion uses the leap second
+    table and MJDref of that context instead of the global ones.
 
     :param vals: input values (scalar, list, array)
     :param fmt_in: input format (e.g. 'secs', 'date', 'jd', ..)
     :param fmt_out: output format (e.g. 'secs', 'date', 'jd', ..)
+    :param return_valid: return validity flags instead of raising (default=False)
+    :param context: time context from ``time_context`` (default=global table)
 
     :returns: converted values as either scalar or numpy array
     """
@@ -561,43 +573,48 @@ def convert_vals(vals, format_in, format_out):
             raise ValueError('Error - specified format {} is not an allowed value {}'
                              .format(fmt, [x.name for x in ok_styles]))
 
-    sys_in, fmt_in, dtype_in = get_style(format_in)
-    sys_out, fmt_out, dtype_out = get_style(format_out)
-
-    vals, ndim = _make_array(vals)
+    with axTime3.trace_span('convert_vals.format'):
+        sys_in, fmt_in, dtype_in = get_style(format_in)
+        sys_out, fmt_out, dtype_out = get_style(format_out)
 
-    # Allow passing bytes to axTime3 by converting to string here. This is
-    # actually silly since later in axTime3.convert_time() it gets encoded back
-    # to ASCII bytes. But since this package is largely deprecated we take the
-    # performance hit in the interest of simpler code.
-    if vals.dtype.kind == 'S':
-        vals = np.char.decode(vals, 'ascii')
-
-    # If the input is already string-like then pass straight to convert_time.
-    # Otherwise convert to string with repr().
-    if vals.dtype.kind == 'U':
-        outs = [axTime3.convert_time(val, sys_in, fmt_in, sys_out, fmt_out)
-                for val in vals.flatten()]
-    else:
-        outs = [axTime3.convert_time(repr(val), sys_in, fmt_in, sys_out, fmt_out)
-                for val in vals.flatten()]
+    with axTime3.trace_span('convert_vals.encode'):
+        vals, ndim = _make_array(vals)
 
+    # String (S or U) and numeric arrays are converted in place by a single
+    # native call, with no per-element Python strings.
     if (six.PY3
             and isinstance(dtype_out, six.string_types)
             and dtype_out.startswith('S')):
         dtype_out = 'U' + dtype_out[1:]
-    outs = np.array(outs, dtype=dtype_out)
+    outs, valid = axTime3.convert_buffer(vals, sys_in, fmt_in, sys_out, fmt_out,
+                                         dtype_out, validate=True, context=context)
+
+    with axTime3.trace_span('convert_vals.postprocess'):
+        if return_valid:
+            return ((outs[0].tolist(), bool(valid[0])) if ndim == 0 else (outs, valid))
+        all_valid = np.all(valid)
+
+    if not all_valid:
+        bad = np.argwhere(~valid)
+        if ndim == 0:
+            where = 'value {!r}'.format(vals[0].tolist())
+        else:
+            where = ', '.join('{} ({!r})'.format(tuple(idx.tolist()) if ndim > 1 else idx[0],
+                                                 vals[tuple(idx)].tolist())
+                              for idx in bad[:5])
+            where = 'values at index ' + where + (', ...' if len(bad) > 5 else '')
+        raise ValueError('Error - invalid {} input {} ({} invalid of {})'
+                         .format(format_in, where, len(bad), valid.size))
 
-    return (outs[0].tolist() if ndim == 0 else outs.reshape(vals.shape))
+    return (outs[0].tolist() if ndim == 0 else outs)
 
 
 def date2secs(dates):
     """
     Convert ``dates`` from the ``date`` system (e.g. '2011:001:12:23:45.001') to
-    the ``secs`` system (CXC seconds).  This does **no input validation** and
-    thus runs much faster than the corresponding ``DateTime(dates).secs``
-    conversion.  Be careful because invalid inputs can give unpredictable
-    results.
+    the ``secs`` system (CXC seconds).  This runs much faster than the
+    corresponding ``DateTime(dates).secs`` conversion.  Invalid dates raise a
+    ``ValueError`` (see ``convert_vals``).
 
     The input ``dates`` can be a single (scalar) value, a Python list or a numpy
     array.  The shape of the output matches the shape of the input.
@@ -611,10 +628,9 @@ def date2secs(dates):
 def secs2date(times):
     """
     Convert ``times`` from the ``secs`` system (CXC seconds) to the ``date``
-    system (e.g. '2011:001:12:23:45.001').  This does **no input validation**
-    and thus runs much faster than the corresponding ``DateTime(times).date``
-    conversion.  Be careful because invalid inputs can give unpredictable
-    results.
+    system (e.g. '2011:001:12:23:45.001').  This runs much faster than the
+    corresponding ``DateTime(times).date`` conversion.  Non-finite times raise
+    a ``ValueError`` (see ``convert_vals``).
 
     The input ``times`` can be a single (scalar) value, a Python list or a numpy
     array.  The shape of the output matches the shape of the input.
@@ -625,6 +641,215 @@ def secs2date(times):
     return convert_vals(times, 'secs', 'date')
 
 
+def secs2nanos(times):
+    """
+    Convert ``times`` from CXC seconds (float) to integer nanoseconds since
+    the same MJDref (int64), rounded to the nanosecond.  The whole seconds
+    are converted exactly, so that the result is as precise as the input.
+    Integer nanoseconds sort, compare and hash exactly and can be converted
+    between time systems with ``convert_nanos``.
+
+    :param times: input times (scalar, list, array of floats)
+    :returns: int64 numpy array with the shape of ``times``
+    """
+    times = np.asarray(times, dtype=np.float64)
+    whole = np.floor(times)
+    return (whole.astype(np.int64) * 1000000000
+            + np.round((times - whole) * 1e9).astype(np.int64))
+
+
+def nanos2secs(nanos):
+    """
+    Convert ``nanos`` from integer nanoseconds since MJDref (int64) to CXC
+    seconds (float64), the nearest double to within one rounding.
+
+    :param nanos: input times (scalar, list, array of ints)
+    :returns: float64 numpy array with the shape of ``nanos``
+    """
+    nanos = np.asarray(nanos, dtype=np.int64)
+    whole, frac = np.divmod(nanos, 1000000000)
+    return whole.astype(np.float64) + frac * 1e-9
+
+
+def convert_nanos(nanos, sys_in='tt', sys_out='utc', context=None):
+    """
+    Convert integer nanoseconds since MJDref (e.g. from ``secs2nanos``) from
+    time system ``sys_in`` to ``sys_out`` ('met', 'tt', 'tai' or 'utc'; the
+    first three are the same in seconds since MJDref).  The conversion uses
+    integer arithmetic only, so that it is exact and round trips outside the
+    leap seconds themselves.
+
+    :param nanos: input times (scalar, list, array of ints)
+    :param sys_in: input time system (default='tt')
+    :param sys_out: output time system (default='utc')
+    :param context: time context from ``time_context`` (default=global table)
+    :returns: int64 numpy array with the shape of ``nanos``
+    """
+    from chandra_time import _axTime3 as axTime3
+    return axTime3.convert_nanos(nanos, sys_in, sys_out, context=context)
+
+
+def convert_hilo(times, sys_in='met', fmt_in='secs', sys_out='tt', fmt_out='jd',
+                 lo=None, context=None):
+    """
+    Convert numeric times from ``sys_in``/``fmt_in`` to ``sys_out``/``fmt_out``
+    (formats 'secs', 'jd' or 'mjd') as double-double pairs ``(hi, lo)``:
+    ``hi`` is the nearest float64 and ``lo`` the rest, so that a JD or MJD
+    keeps the full precision of the time (a single float64 JD is good to
+    only about 20 us).  Pass the ``lo`` of an earlier conversion back in to
+    convert without losing it.
+
+    :param times: input times, or their high parts (scalar, list, array)
+    :param sys_in: input time system (default='met')
+    :param fmt_in: input time format (default='secs')
+    :param sys_out: output time system (default='tt')
+    :param fmt_out: output time format (default='jd')
+    :param lo: low parts of the input times (default=None)
+    :param context: time context from ``time_context`` (default=global table)
+    :returns: tuple of float64 numpy arrays ``(hi, lo)``
+    """
+    from chandra_time import _axTime3 as axTime3
+    return axTime3.convert_hilo(times, sys_in, fmt_in, sys_out, fmt_out,
+                                lo_in=lo, context=context)
+
+
+def leap_table_info():
+    """
+    Return where the leap second table of the native conversion code came
+    from.  The table is compiled in from ``chandra_time/tai-utc.dat``; on the
+    first conversion ``$TIMING_DIR/tai-utc.dat`` or ``$ASC_DATA/tai-utc.dat``
+    replaces it, but that file is only read if it was modified after the
+    compiled-in table was generated.  After that the file is checked again at
+    most once per ``set_leap_check_interval`` seconds, and only read again if
+    it changed.
+
+    :returns: dict with ``file`` ('' if none), ``read_time`` (s), ``entries``,
+              ``fallback`` (bool: compiled-in table in use) and ``lookups``
+              (number of file checks)
+    """
+    from chandra_time import _axTime3 as axTime3
+    return axTime3.leap_info()
+
+
+def refresh_leap_table(force=False):
+    """
+    Check the leap seconds file (see ``leap_table_info``) now and read it if it
+    is a different file or was modified since the table in use was read.  The
+    new table replaces the old one atomically, so conversions in other threads
+    are not blocked.
+
+    :param force: read the file even if it did not change (default=False)
+    :returns: dict as returned by ``leap_table_info``
+    """
+    from chandra_time import _axTime3 as axTime3
+    axTime3.leap_refresh(force)
+    return axTime3.leap_info()
+
+
+def set_leap_check_interval(seconds):
+    """
+    Set the interval at which conversions check the leap seconds file for
+    changes (default 3600 seconds); a check is a ``stat`` of the file, which is
+    only read if it changed.
+
+    :param seconds: interval (s)
+    :returns: previous interval (s)
+    """
+    from chandra_time import _axTime3 as axTime3
+    if seconds < 0:
+        raise ValueError('interval must not be negative')
+    return axTime3.leap_interval(seconds)
+
+
+def time_context(filename=None, mjd=None, tai_utc=None, mjdref=None):
+    """
+    Return a time context for ``convert_vals``: a leap second table of its own
+    and the MJD (TT) that seconds count from, independent of the global table.
+    Conversions in different contexts (e.g. the official table and one with a
+    predicted leap second) can run side by side, in any threads.
+
+    The table is read from ``filename`` (in the format of tai-utc.dat), or
+    given as ``mjd`` (UTC MJD of each leap second) and ``tai_utc`` (TAI-UTC
+    from that date), or else is a copy of the global table in use.  It is not
+    refreshed from the leap seconds file.
+
+    :param filename: leap seconds file
+    :param mjd: leap second dates (UTC MJD)
+    :param tai_utc: TAI-UTC from those dates (s)
+    :param mjdref: MJD (TT) of zero seconds (default=50814.0, 1998.0 TT)
+    :returns: context (``_axTime3.TimeContext``), with the table as ``leaps``
+        and the file it was read from as ``file``
+    """
+    from chandra_time import _axTime3 as axTime3
+    return axTime3.TimeContext(filename=filename, mjd=mjd, tai_utc=tai_utc, mjdref=mjdref)
+
+
+def conversion_stats():
+    """
+    Return the counters and latency histograms of the native conversion code
+    for the calling thread, or None if they are not compiled in.  They are
+    compiled in when the package is built with the ``CHANDRA_TIME_STATS``
+    environment variable set.
+
+    The ``counters`` dict counts the conversion paths taken (e.g. ``set_utc``
+    for UTC inputs, ``leap_second`` for times inside a leap second,
+    ``leaps_read`` for reads of tai-utc.dat, ``input_rejected`` for invalid
+    inputs).  The ``histograms`` dict has uint64 arrays of log2-bucketed
+    latencies: element ``b`` counts the calls that took 2**b to 2**(b+1)-1 ns.
+    The ``allocations`` dict has the heap allocations and bytes per native API
+    call and allocated type (see ``_axTime3.stats``).
+
+    :returns: dict with ``counters``, ``histograms`` and ``allocations``, or None
+    """
+    from chandra_time import _axTime3 as axTime3
+    return axTime3.stats()
+
+
+def reset_conversion_stats():
+    """
+    Clear the counters and histograms returned by ``conversion_stats`` for the
+    calling thread.
+    """
+    from chandra_time import _axTime3 as axTime3
+    axTime3.reset_stats()
+
+
+def start_conversion_trace(filename, sample=1000, max_events=1000000):
+    """
+    Start tracing the stages of the native conversions: in ``convert_vals``
+    the format lookup, input encoding and postprocessing, and in the native
+    code the batch call, input parsing (``getinput``), ``XTime::set``,
+    ``XTime::get`` / ``XTime::getDate`` and output formatting
+    (``putoutput``).  ``stop_conversion_trace`` writes the spans to
+    ``filename`` as Chrome trace-event JSON, which chrome://tracing or
+    https://ui.perfetto.dev display.
+
+    To keep the overhead bounded on large batches, the stages of the
+    individual times are traced for one time in ``sample``, and at most
+    ``max_events`` spans are kept.  Tracing is compiled in when the package is
+    built with the ``CHANDRA_TIME_TRACE`` environment variable set.
+
+    :param filename: trace file to write
+    :param sample: trace the stages of one time in ``sample`` (default=1000)
+    :param max_events: maximum number of spans kept (default=1000000)
+    :returns: True, or False if tracing is not compiled in
+    """
+    from chandra_time import _axTime3 as axTime3
+    return axTime3.trace_start(filename, sample, max_events)
+
+
+def stop_conversion_trace():
+    """
+    Stop the trace started by ``start_conversion_trace`` and write the trace
+    file.
+
+    :returns: dict with the number of ``events`` written and ``dropped``, or
+              None if no trace was started
+    """
+    from chandra_time import _axTime3 as axTime3
+    return axTime3.trace_stop()
+
+
 def convert(time_in, sys_in=None, fmt_in=None, sys_out=None, fmt_out='secs'):
     """Base routine to convert from/to any format."""
     if time_in is None:
@@ -634,6 +859,9 @@ def convert(time_in, sys_in=None, fmt_in=None, sys_out=None, fmt_out='secs'):
 
     # Does is behave like a numpy ndarray with non-zero dimension?
     if hasattr(time_in, 'shape') and hasattr(time_in, 'flatten') and time_in.shape:
+        time_out = _convert_ndarray(time_in, sys_in, fmt_in, sys_out, fmt_out)
+        if time_out is not None:
+            return time_out
         time_out = [_convert(x, sys_in, fmt_in, sys_out, fmt_out) for x in time_in.flatten()]
         return np.array(time_out).reshape(time_in.shape)
     else:
@@ -646,11 +874,11 @@ def convert(time_in, sys_in=None, fmt_in=None, sys_out=None, fmt_out='secs'):
             return _convert(time_in, sys_in, fmt_in, sys_out, fmt_out)
 
 
-def _convert(time_in, sys_in, fmt_in, sys_out, fmt_out):
-    """Base routine to convert from/to any format."""
-
-    from chandra_time import _axTime3 as axTime3
-
+def _match_style(time_in, fmt_in):
+    """
+    Return the time style that matches ``time_in`` (only ``fmt_in`` if given),
+    with the matched input string in its ``time_in`` attribute, or None.
+    """
     # See if time_in works as a float after first getting the string version.
     # For an actual float input this then gets the full-precision representation.
     # For time_in = mx.DateTime object then the try will fail through.
@@ -664,13 +892,122 @@ def _convert(time_in, sys_in, fmt_in, sys_out, fmt_out):
         if fmt_in and time_style.name != fmt_in:
             continue
         if time_style.match(time_in):
-            time_in = time_style.time_in
-            ax3_fmt_in = time_style.ax3_fmt
-            ax3_sys_in = time_style.ax3_sys
-            preprocess = time_style.preprocess
-            break
+            return time_style
+    return None
+
+
+def _named_style(fmt):
+    """Return the time style called ``fmt``, or None."""
+    for time_style in time_styles:
+        if time_style.name == fmt:
+            return time_style
+    return None
+
+
+def _relday_or_greta(vals):
+    """
+    Flag the elements of string array ``vals`` that look like numbers but could
+    be 'relday' (leading sign) or 'greta' (seven digits and a point) values
+    rather than 'secs' when the format is detected.
+    """
+    vals = np.ascontiguousarray(vals)
+    charsize = 1 if vals.dtype.kind == 'S' else 4
+    codes = vals.view(np.uint8 if charsize == 1 else np.uint32)
+    codes = codes.reshape(vals.size, vals.dtype.itemsize // charsize)
+    flags = (codes[:, 0] == ord('+')) | (codes[:, 0] == ord('-'))
+    if codes.shape[1] >= 8:
+        digits = (codes[:, :7] >= ord('0')) & (codes[:, :7] <= ord('9'))
+        flags |= np.all(digits, axis=1) & (codes[:, 7] == ord('.'))
+    return flags
+
+
+def _convert_ndarray(time_in, sys_in, fmt_in, sys_out, fmt_out):
+    """
+    Convert the numeric or string (S, U) array ``time_in`` with one native call.
+
+    The input format is ``fmt_in`` or else that of the first element.  Every
+    element is checked natively against that format, and the ones that fail
+    (another format in a mixed array, or an invalid value) are converted one
+    at a time by ``_convert``, which also raises the usual errors.  Returns
+    None if the array or formats cannot be converted natively, in which case
+    the caller uses ``_convert`` for every element.
+    """
+    from chandra_time import _axTime3 as axTime3
+
+    vals = np.asarray(time_in)
+    if vals.dtype.kind not in 'SUiuf' or vals.size == 0:
+        return None
+    numeric = vals.dtype.kind not in 'SU'
+    flat = vals.reshape(-1)
+
+    # Input style, which must be one that axTime3 reads without preprocessing.
+    # Numbers are 'secs' unless they look like 'relday' or 'greta' values.
+    if fmt_in or not numeric:
+        first = flat[0]
+        if isinstance(first, bytes) and not isinstance(first, str):
+            first = first.decode('ascii', 'replace')
+        style_in = _match_style(first, fmt_in) if not fmt_in else _named_style(fmt_in)
     else:
+        style_in = _named_style('secs')
+    style_out = _named_style(fmt_out)
+    if (style_in is None or style_out is None or not style_in.dtype
+            or (numeric and style_in.ax3_fmt not in ('s', 'j', 'm'))):
+        return None
+
+    try:
+        ax3_sys_in = time_system[sys_in] if sys_in else style_in.ax3_sys
+        ax3_sys_out = time_system[sys_out] if sys_out else style_out.ax3_sys
+    except KeyError:
+        return None
+
+    # Numeric axTime3 output for 'secs', 'jd', 'mjd' and the numeric styles
+    # derived from them, otherwise strings of the style dtype width.
+    if style_out.ax3_fmt in ('s', 'j', 'm'):
+        dtype_out = np.float64
+    else:
+        width = int(style_out.dtype[1:]) if style_out.dtype else 40
+        dtype_out = ('U' if six.PY3 else 'S') + str(width)
+
+    out, valid = axTime3.convert_buffer(flat, ax3_sys_in, style_in.ax3_fmt,
+                                        ax3_sys_out, style_out.ax3_fmt,
+                                        dtype_out, validate=True)
+    if not fmt_in and style_in.name == 'secs':
+        if numeric:
+            nums = flat.astype(np.float64)
+            valid &= ~(np.signbit(nums) | ((nums >= 1e6) & (nums < 2099001.0)))
+        else:
+            valid &= ~_relday_or_greta(flat)
+
+    # Styles with a dtype need no postprocessing (beyond float for numbers);
+    # the others give a list like _convert, to get the same array type.
+    if not style_out.dtype:
+        out = out.tolist()
+        if style_out.postprocess:
+            for idx, ok in enumerate(valid):
+                if ok:
+                    out[idx] = style_out.postprocess(out[idx])
+
+    bad = np.flatnonzero(~valid)
+    if len(bad):
+        orig = time_in.flatten()
+        for idx in bad:
+            out[idx] = _convert(orig[idx], sys_in, fmt_in, sys_out, fmt_out)
+
+    return np.array(out).reshape(vals.shape)
+
+
+def _convert(time_in, sys_in, fmt_in, sys_out, fmt_out):
+    """Base routine to convert from/to any format."""
+
+    from chandra_time import _axTime3 as axTime3
+
+    time_style = _match_style(time_in, fmt_in)
+    if time_style is None:
         raise ChandraTimeError("Invalid input format '%s'" % fmt_in)
+    time_in = time_style.time_in
+    ax3_fmt_in = time_style.ax3_fmt
+    ax3_sys_in = time_style.ax3_sys
+    preprocess = time_style.preprocess
 
     if sys_in:
         if sys_in in time_system:
@@ -778,9 +1115,54 @@ class DateTime(object):
         try:
             self.time_in = time_in.time_in
             self.format = time_in.format
+            # Share the canonical secs if the other DateTime already has them
+            self._secs_cache = time_in._secs_cache
         except AttributeError:
             self.time_in = time_in
             self.format = format
+            self._secs_cache = None
+
+    def _get_secs(self):
+        """
+        Return the canonical CXC seconds (TT) of ``time_in`` and the kind of
+        container it came in.
+
+        The input is converted once on first call and cached.  The seconds are
+        a float64 ndarray with the shape of the original input (0-d for a
+        scalar) and the kind is one of 'scalar', 'list' or 'array', which
+        determines the container for every output format.
+        """
+        if self._secs_cache is None:
+            secs = convert(self.time_in, fmt_in=self.format, fmt_out='secs')
+            if isinstance(secs, np.ndarray):
+                kind = 'array'
+            elif isinstance(secs, list):
+                kind = 'list'
+            else:
+                kind = 'scalar'
+            self._secs_cache = (np.asarray(secs, dtype=np.float64), kind)
+        return self._secs_cache
+
+    def _from_secs(self, fmt_out):
+        """Convert the cached canonical seconds to ``fmt_out``."""
+        secs, kind = self._get_secs()
+
+        if fmt_out == 'secs':
+            out = secs.copy()
+        elif fmt_out == 'numday':
+            # Seconds to 1e-10, below the round-off of the cached secs
+            return convert(self.time_in, fmt_in=self.format, fmt_out=fmt_out)
+        elif fmt_out in FAST_FORMATS:
+            out = convert_vals(secs, 'secs', fmt_out)
+        else:
+            # Formats with pre/post-processing go through the general
+            # converter, starting from secs so no format detection is needed.
+            time_in = secs if kind == 'array' else secs.tolist()
+            return convert(time_in, fmt_in='secs', fmt_out=fmt_out)
+
+        if kind == 'array':
+            return out
+        return np.asarray(out).tolist()
 
     @property
     def cxotime(self):
@@ -795,19 +1177,36 @@ class DateTime(object):
         if fmt_out.startswith('_'):
             return self.__getattribute__(fmt_out)
 
-        return convert(self.time_in,
-                       fmt_in=self.format,
-                       fmt_out=fmt_out,
-                       )
+        return self._from_secs(fmt_out)
+
+    def _get_utc_mjd(self):
+        """
+        Return the cached secs as UTC MJD in double-double ``(hi, lo)`` pairs
+        (see ``convert_hilo``), so that arithmetic in days matches UTC calendar
+        days without losing the precision of the secs.
+        """
+        from chandra_time import _axTime3 as axTime3
+
+        secs, kind = self._get_secs()
+        hi, lo = axTime3.convert_hilo(secs, 'm', 's', 'u', 'm')
+        return hi, lo, kind
 
     def __add__(self, days):
-        return DateTime(self.jd + days, format='jd')
+        hi, lo, kind = self._get_utc_mjd()
+        return _datetime_from_utc_mjd(hi, lo, np.asarray(days, dtype=np.float64),
+                                      _arith_kind(kind, days))
 
     def __sub__(self, other):
+        hi, lo, kind = self._get_utc_mjd()
         if isinstance(other, DateTime):
-            return self.jd - other.jd
+            other_hi, other_lo, other_kind = other._get_utc_mjd()
+            mjd, frac = _utc_day_parts(hi, lo)
+            other_mjd, other_frac = _utc_day_parts(other_hi, other_lo)
+            delta = (mjd - other_mjd) + (frac - other_frac)
+            return _from_kind(delta, _arith_kind(kind, other_kind))
         else:
-            return DateTime(self.jd - other, format='jd')
+            return _datetime_from_utc_mjd(hi, lo, -np.asarray(other, dtype=np.float64),
+                                          _arith_kind(kind, other))
 
     @override__dir__
     def __dir__(self):
@@ -815,13 +1214,18 @@ class DateTime(object):
 
     def day_start(self):
         """Return a new DateTime object corresponding to the start of the day."""
-        date = self.date.split(':')
-        return DateTime('%s:%s:00:00:00' % (date[0], date[1]))
+        return self._day_start(0)
 
     def day_end(self):
         """Return a new DateTime object corresponding to the end of the day."""
-        date = self.date.split(':')
-        return DateTime('%s:%03d:00:00:00' % (date[0], int(date[1]) + 1))
+        return self._day_start(1)
+
+    def _day_start(self, ndays):
+        """Return a DateTime for the start of the UTC day plus ``ndays``."""
+        from chandra_time import _axTime3 as axTime3
+
+        secs, kind = self._get_secs()
+        return _datetime_from_secs(axTime3.day_start(secs, ndays), kind)
 
     @property
     def time_attributes(self):
@@ -829,39 +1233,17 @@ class DateTime(object):
             return self._time_attributes
 
         if not hasattr(self, '_time_attributes'):
-            # date       YYYY:DDD:hh:mm:ss.ss..                          utc
-            # iso        YYYY-MM-DD hh:mm:ss.ss..                        utc
-            date = self.date
-            iso = self.iso
-            mjd = self.mjd
-
-            # Coerce list output into np.array
-            if isinstance(date, list):
-                date = np.array(date)
-                iso = np.array(iso)
-                mjd = np.array(mjd)
-
-            monday_mjd = DateTime('2015:159:00:00:00').mjd
-            is_array = hasattr(date, 'shape') and hasattr(date, 'flatten') and date.shape
-
-            def slice_string(val, i0, i1, out_type):
-                slc = slice(i0, i1)
-                if is_array:
-                    out = np.array([x[slc] for x in val]).astype(out_type)
-                else:
-                    out = out_type(val[slc])
-                return out
+            from chandra_time import _axTime3 as axTime3
+
+            # All fields are computed from the cached secs in one native call,
+            # with the seconds rounded to 3 decimals as in the date string.
+            secs, kind = self._get_secs()
+            fields = axTime3.time_fields(secs, 3)
 
             ta = {}
-            ta['year'] = slice_string(date, 0, 4, int)
-            ta['yday'] = slice_string(date, 5, 8, int)
-            ta['hour'] = slice_string(date, 9, 11, int)
-            ta['min'] = slice_string(date, 12, 14, int)
-            ta['sec'] = slice_string(date, 15, None, float)
-            ta['mon'] = slice_string(iso, 5, 7, int)
-            ta['day'] = slice_string(iso, 8, 10, int)
-            wday = np.mod(np.floor(mjd - monday_mjd), 7)
-            ta['wday'] = wday.astype(int) if is_array else int(wday)
+            for name, val in fields.items():
+                out_type = float if name == 'sec' else int
+                ta[name] = out_type(val) if kind == 'scalar' else val.astype(out_type)
 
             self._time_attributes = ta
 
@@ -877,6 +1259,62 @@ class DateTime(object):
     wday = TimeAttribute('wday')
 
 
+def _arith_kind(kind, other):
+    """
+    Return the container kind for the result of arithmetic between a DateTime
+    with container ``kind`` and ``other``, which is either the kind of another
+    DateTime or a delta time.  Lists stay lists unless numpy is involved.
+    """
+    if isinstance(other, np.ndarray) or 'array' in (kind, other):
+        return 'array'
+    if 'list' in (kind, other) or isinstance(other, (list, tuple)):
+        return 'list'
+    return 'scalar'
+
+
+def _from_kind(vals, kind):
+    """Return ndarray ``vals`` in the container for ``kind``."""
+    if kind == 'array' and vals.ndim > 0:
+        return vals
+    return vals.tolist()
+
+
+def _utc_day_parts(hi, lo):
+    """
+    Split UTC MJD ``hi + lo`` into whole days and the fraction of the day,
+    the latter rounded to the microsecond: well below the precision of a JD
+    difference, but above the round-off of the secs, so that times on whole
+    days differ by exactly whole days.
+    """
+    mjd = np.floor(hi)
+    frac = np.round(((hi - mjd) + lo) * 86400e6) / 86400e6
+    return mjd, frac
+
+
+def _datetime_from_utc_mjd(hi, lo, days, kind):
+    """
+    Make a DateTime from UTC MJD ``hi + lo`` (see ``_get_utc_mjd``) plus
+    ``days``, with the canonical secs already cached.  The sum keeps its
+    rounding error (two-sum) in the low part.
+    """
+    from chandra_time import _axTime3 as axTime3
+
+    total = hi + days
+    part = total - hi
+    lo = lo + ((hi - (total - part)) + (days - part))
+    secs, _ = axTime3.convert_hilo(total, 'u', 'm', 'm', 's', lo_in=lo)
+    if kind == 'array' and secs.ndim == 0:
+        kind = 'scalar'
+    return _datetime_from_secs(secs, kind)
+
+
+def _datetime_from_secs(secs, kind):
+    """Make a DateTime from canonical ``secs`` with them already cached."""
+    out = DateTime(_from_kind(secs, kind), format='secs')
+    out._secs_cache = (secs, kind)
+    return out
+
+
 def command_line_convert_time():
     import argparse
 
@@ -16,31 +16,40 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <cstdint>
 #include <iostream>
+#include <chrono>
 #include "XTime.h"
+#include "XTimeStats.h"
+#include "XTimeTrace.h"
+#include "XTimeLeaps.h"
 #define TAIUTC "tai-utc.dat"
 
 using namespace std;
 
-int          XTime::NUMOBJECTS  =       0       ; // Number of instantiated XTime objects
+std::atomic<int> XTime::NUMOBJECTS (0) ; // Number of instantiated XTime objects
 const double XTime::MJD0        = 2400000.5     ; // JD - MJD
 const long   XTime::MJD1972     =   41317       ; // MJD at 1972
 const double XTime::DAY2SEC     =   86400.0     ; // Seconds per day
 const double XTime::SEC2DAY     = 1.0 / DAY2SEC ; // Inverse seconds per day
+const long long XTime::NSPERDAY = 86400000000000LL ; // Nanoseconds per day
 const long   XTime::MJDREFint   =   50814       ; // MJD at 1998.0
 const double XTime::MJDREFfr    =       0.0     ; // MJD at 1998.0
 const double XTime::REFLEAPS    =      31.0     ;  // Leap seconds at default MJDREF (1998.0 TT)
 const double XTime::TAI2TT      =      32.184   ; // TT - TAI
-int    XTime::NUMLEAPSECS = 0 ;      // Leap seconds: 1972 through Jan 2017
-long   XTime::LEAPSMJD[]  = {41317, 41499, 41683, 42048, 42413, 42778, 43144, 43509, 43874,
-			     44239, 44786, 45151, 45516, 46247, 47161, 47892, 48257, 48804,
-			     49169, 49534, 50083, 50630, 51179, 53736, 54832, 56109, 57204,
-                             57754} ;
-double XTime::LEAPSECS[]  = {10, 11, 12,13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
-			     26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37} ;
-time_t XTime::WALLCLOCK0      ;      // Wallclock time when leap seconds were read
-
-static int daymonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31} ;
+std::atomic<const XTimeLeapTable*> XTime::LEAPS (nullptr) ; // Leap second table in use
+std::atomic<time_t> XTime::WALLCLOCK0 (0) ; // Wallclock time of the last leap seconds file check
+std::atomic<int> XTime::LEAPSBUSY (0) ;  // A leap seconds file check is in progress
+std::atomic<double> XTime::LEAPSINTERVAL (3600.0) ;  // Seconds between leap seconds file checks
+std::atomic<double> XTime::LEAPSREADTIME (0.0) ;  // Time taken by the last file check and read (s)
+std::atomic<int> XTime::LEAPSLOOKUPS (0) ;  // Number of leap seconds file checks
+
+// Days per month, in common [0] and leap [1] years; read only, so that
+// conversions in different threads do not interfere
+static const int daymonth[2][12] = {{31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
+				    {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}} ;
 static const char*  const month[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
          "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"} ;
 
@@ -51,90 +60,324 @@ static const char*  const month[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
 //
 
 // Description:
-// Function to set leap second table
-// If it was more than abs(dt) seconds since the
-// leap seconds were read, the leap second table
-// is refreshed; if dt > 0, only additional leap
-// seconds are added; if dt < 0, all leap seconds
-// are refreshed.  The default is dt=5000000 (about
-// two months).
+// Function to keep the leap second table current, called by
+// every constructor: if it was LEAPSINTERVAL seconds or more
+// since the leap seconds file was checked, check it now.  Objects
+// of a context with a table of its own (see XTimeContext) do not
+// use the file.
 // This is the private method; for the public method
 // use void XTime::setLeaps (double dt).
 
-void XTime::setleaps (double dt)
+void XTime::setleaps (void)
 {
   // Increment the object counter:
-  NUMOBJECTS++ ;
+  NUMOBJECTS.fetch_add (1, std::memory_order_relaxed) ;
+  XTSTAT_COUNT (XTS_SETLEAPS) ;
 
   // Now the business of the leap seconds
-  int refresh = 0 ;
+  if ( table )
+    return ;
+  double dt = LEAPSINTERVAL.load (std::memory_order_relaxed) ;
+  if ( !LEAPS.load (std::memory_order_acquire)
+       || ( difftime (time (NULL), WALLCLOCK0.load (std::memory_order_relaxed)) >= dt ) )
+    checkleaps (dt) ;
+  return ;
+}
+
+//
+//   -------------------------
+// -- XTime::initleaps (void) --
+//   -------------------------
+//
+
+// Description:
+// Put the built-in leap second table, compiled in from tai-utc.dat
+// (XTimeLeaps.h), in use unless there is a table already; return
+// the table in use.  No file is needed for that.
+
+const XTimeLeapTable* XTime::initleaps (void)
+{
+  static const XTimeLeapTable *builtin = [] {
+    XTSTAT_COUNT (XTS_LEAPS_BUILTIN) ;
+    XTimeLeapTable *leaps = new XTimeLeapTable () ;
+    leaps->mjd.assign (XTIME_LEAPS_BUILTIN_MJD, XTIME_LEAPS_BUILTIN_MJD + XTIME_LEAPS_BUILTIN_NUM) ;
+    leaps->secs.assign (XTIME_LEAPS_BUILTIN_SECS, XTIME_LEAPS_BUILTIN_SECS + XTIME_LEAPS_BUILTIN_NUM) ;
+    leaps->num = XTIME_LEAPS_BUILTIN_NUM ;
+    makeSegments (leaps, MJDREFint, MJDREFfr, &leaps->segments) ;
+    return (const XTimeLeapTable *) leaps ;
+  } () ;
+  const XTimeLeapTable *leaps = NULL ;
+  if ( LEAPS.compare_exchange_strong (leaps, builtin, std::memory_order_acq_rel) )
+    return builtin ;
+  return leaps ;
+}
+
+//
+//   -------------------------------
+// -- XTime::checkleaps (double dt) --
+//   -------------------------------
+//
+
+// Description:
+// The one place where the leap seconds file is looked for and read.
+// $TIMING_DIR/tai-utc.dat, or else $ASC_DATA/tai-utc.dat, is checked
+// (stat) if it was abs(dt) seconds or more since the last check;
+// it is only read if it is a different file, or was modified or
+// changed size, since the table in use was read, or, for the
+// built-in table, since it was last compared with it; it then
+// replaces the built-in table only if it has a different number of
+// leap seconds or a different last one.
+// If dt > 0, only additional leap seconds are added; if dt < 0, the
+// file is read even if it did not change and all leap seconds are
+// refreshed.  A file that cannot be read, has a line that is not in
+// the format of tai-utc.dat, or dates out of order (see parseLeaps) is
+// not used.  The new table is built aside and swapped in, so
+// conversions in progress keep using the old one; while one thread
+// checks, the others go on without waiting.
+
+void XTime::checkleaps (double dt)
+{
   int all = dt < 0.0 ;
   if ( all ) dt = -dt ;
-  // If they were set before, check whether they expired
-  if ( NUMLEAPSECS ) {
-    time_t wallclock1 ;
-    time (&wallclock1) ;
-    if ( difftime (wallclock1, WALLCLOCK0) > dt )
-      refresh = 1 ;
+  const XTimeLeapTable *leaps = leapTable () ;
+  time_t wallclock1 = time (NULL) ;
+  if ( !all && LEAPSLOOKUPS.load (std::memory_order_relaxed)
+       && ( difftime (wallclock1, WALLCLOCK0.load (std::memory_order_relaxed)) < dt ) )
+    return ;
+  if ( LEAPSBUSY.exchange (1, std::memory_order_acquire) )
+    return ;
+
+  // The file last compared with the built-in table (only used while busy)
+  static XTimeLeapTable checked ;
+  char *filepath ;
+  char lsfile[256] ;
+  struct stat st ;
+  int found = 0 ;
+  int doread = 0 ;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now () ;
+  LEAPSLOOKUPS.fetch_add (1, std::memory_order_relaxed) ;
+
+  // Did the user provide his/her own?
+  if ( filepath = getenv("TIMING_DIR") ) {
+    snprintf (lsfile, sizeof (lsfile), "%s/%s", filepath, TAIUTC) ;
+    found = !stat (lsfile, &st) ;
   }
-  else
-    refresh = 1 ;
-
-  // Try to read the leap seconds file
-  if ( refresh ) {
-    char *filepath ;
-    FILE *FF = NULL ;
-    char lsfile[256] ;
-    int nums = 0 ;
-
-    // Did the user provide his/her own?
-    if ( filepath = getenv("TIMING_DIR") ) {
-      sprintf (lsfile, "%s/%s", filepath, TAIUTC) ;
-      FF = fopen (lsfile, "r") ;
+
+  // Otherwise, the standard file
+  if ( !found )
+    if ( filepath = getenv ("ASC_DATA") ) {
+      snprintf (lsfile, sizeof (lsfile), "%s/%s", filepath, TAIUTC) ;
+      found = !stat (lsfile, &st) ;
     }
 
-    // Otherwise, the standard file
-    if ( FF == NULL )
-      if ( filepath = getenv ("ASC_DATA") ) {
-	sprintf (lsfile, "%s/%s", filepath, TAIUTC) ;
-	FF = fopen (lsfile, "r") ;
-      }
+  // Only read it if it changed
+  if ( found ) {
+    int changed ;
+    if ( leaps->file[0] )
+      changed = strcmp (lsfile, leaps->file) || ( (long) st.st_dev != leaps->dev )
+	|| ( (long) st.st_ino != leaps->ino ) || ( st.st_mtime != leaps->mtime )
+	|| ( (long) st.st_size != leaps->size ) ;
+    else
+      changed = strcmp (lsfile, checked.file) || ( (long) st.st_dev != checked.dev )
+	|| ( (long) st.st_ino != checked.ino ) || ( st.st_mtime != checked.mtime )
+	|| ( (long) st.st_size != checked.size ) ;
+    doread = all || changed ;
+  }
 
-    // If the file is found, read it (only post 1972)
-    if ( FF ) {
-      long leapsMD ;
-      double leapsecs ;
-      int i ;
-      while ( fscanf (FF, "%d %*s  1 =JD 24%ld.5 %*s %lg S + (MJD - %*lg) X %*lg %*s",
-		      &i, &leapsMD, &leapsecs) == 3 ) {
-	if ( i > 1970 ) {
-	  // Only overwrite existing values when forced to do so
-	  if ( all || ( nums >= NUMLEAPSECS ) ) {
-	    LEAPSMJD[nums] = leapsMD ;
-	    LEAPSECS[nums] = leapsecs ;
-	    nums++ ;
-	  }
-	}
-      }
-      int error = ferror (FF) ;
-      fclose (FF) ;
-      // If we got fewer leap seconds than before, there must have been an error
-      if ( ( nums >= NUMLEAPSECS ) && !error ) {
-	time (&WALLCLOCK0) ;
-	NUMLEAPSECS = nums ;
+  // If it is to be read, read it (only post 1972) into a new table
+  if ( doread ) {
+    XTSTAT_COUNT (XTS_LEAPS_READ) ;
+    XTSTAT_TIME (XTH_LEAPS_READ) ;
+    XTimeLeapTable *fresh = new XTimeLeapTable () ;
+    int nums = readLeaps (lsfile, fresh) ;
+    // The built-in table stays in use if the file has the same leap seconds
+    int same = !leaps->file[0] && ( nums > 0 ) && ( nums == leaps->num )
+      && ( fresh->mjd[nums-1] == leaps->mjd[nums-1] ) ;
+    if ( !leaps->file[0] ) {
+      strcpy (checked.file, lsfile) ;
+      checked.mtime = st.st_mtime ;
+      checked.size = (long) st.st_size ;
+      checked.dev = (long) st.st_dev ;
+      checked.ino = (long) st.st_ino ;
+    }
+    // Only overwrite existing values when forced to do so
+    if ( !all )
+      for (int i=0; ( i < nums ) && ( i < leaps->num ); i++) {
+	fresh->mjd[i] = leaps->mjd[i] ;
+	fresh->secs[i] = leaps->secs[i] ;
       }
+    // If we got fewer leap seconds than before, there must have been an error
+    if ( ( nums > 0 ) && ( all || ( !same && ( nums >= leaps->num ) ) ) ) {
+      fresh->num = nums ;
+      strcpy (fresh->file, lsfile) ;
+      fresh->mtime = st.st_mtime ;
+      fresh->size = (long) st.st_size ;
+      fresh->dev = (long) st.st_dev ;
+      fresh->ino = (long) st.st_ino ;
+      makeSegments (fresh, MJDREFint, MJDREFfr, &fresh->segments) ;
+      // The old table is not freed: conversions may still be using it
+      LEAPS.store (fresh, std::memory_order_release) ;
     }
+    else
+      delete fresh ;
+  }
+  WALLCLOCK0.store (wallclock1, std::memory_order_relaxed) ;
+  LEAPSREADTIME.store (std::chrono::duration<double> (std::chrono::steady_clock::now () - t0).count (),
+		       std::memory_order_relaxed) ;
+  LEAPSBUSY.store (0, std::memory_order_release) ;
+  return ;
+}
 
-    // File could not be found; use the ones we know about when coding
-    else if ( !NUMLEAPSECS ) {
-      nums = 28 ;                 // Leap seconds: 1972.0 through Jan 2017
-      NUMLEAPSECS = nums ;
-    }
+//
+//   -------------------------------------------------------------------------
+// -- XTime::scanLeapLine (const char *s, int *year, long *mjd, double *secs) --
+//   -------------------------------------------------------------------------
+//
+
+// Description:
+// Scan the line of a tai-utc.dat file at s, e.g.
+//   " 1972 JAN  1 =JD 2441317.5  TAI-UTC=  10.0       S + (MJD - 41317.) X 0.0      S"
+// for its year, MJD (from the JD, which must end in .5), and TAI-UTC;
+// the rest of the line is not checked.  Returns 1 for such a line,
+// 0 for an empty one, and -1 if the line does not have this format.
+int XTime::scanLeapLine (const char *s, int *year, long *mjd, double *secs)
+{
+  char *e ;
+  long jd ;
+  int n ;
+
+  while ( isblank ((unsigned char) *s) || ( *s == '\r' ) )
+    s++ ;
+  if ( !*s || ( *s == '\n' ) )
+    return 0 ;
+
+  // Year, month, day
+  for (n=0, *year=0; isdigit ((unsigned char) *s) && ( n < 6 ); n++)
+    *year = *year * 10 + ( *s++ - '0' ) ;
+  if ( !n || !isblank ((unsigned char) *s) )
+    return -1 ;
+  while ( isblank ((unsigned char) *s) )
+    s++ ;
+  for (n=0; isalpha ((unsigned char) *s); n++)
+    s++ ;
+  if ( !n || !isblank ((unsigned char) *s) )
+    return -1 ;
+  while ( isblank ((unsigned char) *s) )
+    s++ ;
+  for (n=0; isdigit ((unsigned char) *s); n++)
+    s++ ;
+  if ( !n )
+    return -1 ;
+  while ( isblank ((unsigned char) *s) )
+    s++ ;
+
+  // =JD 24nnnnn.5
+  if ( strncmp (s, "=JD", 3) )
+    return -1 ;
+  s += 3 ;
+  while ( isblank ((unsigned char) *s) )
+    s++ ;
+  for (n=0, jd=0; isdigit ((unsigned char) *s) && ( n < 8 ); n++)
+    jd = jd * 10 + ( *s++ - '0' ) ;
+  if ( ( n != 7 ) || ( jd < 2400000 ) || strncmp (s, ".5", 2)
+       || !isblank ((unsigned char) s[2]) )
+    return -1 ;
+  *mjd = jd - 2400000 ;
+  s += 2 ;
+
+  // TAI-UTC=  nn.n
+  while ( isblank ((unsigned char) *s) )
+    s++ ;
+  while ( *s && !isspace ((unsigned char) *s) )
+    s++ ;
+  while ( isblank ((unsigned char) *s) )
+    s++ ;
+  *secs = strtod (s, &e) ;
+  if ( ( e == s ) || !isspace ((unsigned char) *e) )
+    return -1 ;
+  return 1 ;
+}
 
+//
+//   ------------------------------------------------------------
+// -- XTime::parseLeaps (const char *buf, XTimeLeapTable *leaps) --
+//   ------------------------------------------------------------
+//
+
+// Description:
+// Parse buf, the NUL-terminated contents of a tai-utc.dat file, into
+// the mjd and secs of table leaps, keeping only the entries after
+// 1970 (the leap seconds proper), in one pass: every line must have
+// the format of the USNO file (see scanLeapLine), the dates must
+// increase, and TAI-UTC must not decrease.  Returns the number of
+// entries, which is also put in leaps->num, or minus the number of the
+// first line that is wrong, in which case leaps is left empty.
+int XTime::parseLeaps (const char *buf, XTimeLeapTable *leaps)
+{
+  const char *s = buf ;
+  int line = 0 ;
+  int year, ok ;
+  long mjd ;
+  double secs ;
+
+  leaps->mjd.clear () ;
+  leaps->secs.clear () ;
+  leaps->num = 0 ;
+  while ( *s ) {
+    line++ ;
+    ok = scanLeapLine (s, &year, &mjd, &secs) ;
+    const char *eol = strchr (s, '\n') ;
+    s = eol ? eol + 1 : s + strlen (s) ;
+    if ( !ok )
+      continue ;
+    if ( ( ok < 0 )
+	 || ( ( year > 1970 ) && leaps->num
+	      && ( ( mjd <= leaps->mjd.back () ) || ( secs < leaps->secs.back () ) ) ) ) {
+      leaps->mjd.clear () ;
+      leaps->secs.clear () ;
+      leaps->num = 0 ;
+      return -line ;
+    }
+    if ( year > 1970 ) {
+      leaps->mjd.push_back (mjd) ;
+      leaps->secs.push_back (secs) ;
+      leaps->num++ ;
+    }
   }
-  return ;
+  return leaps->num ;
 }
-
+
+//
+//   ------------------------------------------------------------
+// -- XTime::readLeaps (const char *file, XTimeLeapTable *leaps) --
+//   ------------------------------------------------------------
+//
+
+// Description:
+// Read leap seconds file file (in the format of tai-utc.dat) into
+// table leaps: the whole file is read into one buffer and parsed by
+// parseLeaps.  Returns the number of entries, 0 if the file could not
+// be read, or minus the number of the first line that is wrong.
+int XTime::readLeaps (const char *file, XTimeLeapTable *leaps)
+{
+  std::vector<char> buf ;
+  size_t n = 0 ;
+  FILE *FF = fopen (file, "r") ;
+
+  leaps->num = 0 ;
+  if ( FF == NULL )
+    return 0 ;
+  buf.resize (4096) ;
+  while ( ( n += fread (buf.data () + n, 1, buf.size () - n - 1, FF) ) == buf.size () - 1 )
+    buf.resize (2 * buf.size ()) ;
+  int error = ferror (FF) ;
+  fclose (FF) ;
+  if ( error )
+    return 0 ;
+  buf[n] = 0 ;
+  return parseLeaps (buf.data (), leaps) ;
+}
+
 //
 //   -------------------------------------------------------------
 // -- XTime::setmyleaps (double *leapval, long mjdi, double mjdf) --
@@ -147,21 +390,267 @@ void XTime::setleaps (double dt)
 // Return 1 if mjdi+mjdf falls during a leap second; otherwise 0.
 int XTime::setmyleaps (double *leapval, long mjdi, double mjdf)
 {
-  int i = NUMLEAPSECS - 1 ;
+  XTSTAT_COUNT (XTS_SETMYLEAPS) ;
+  return leapsAt (myTable (), leapval, mjdi, mjdf) ;
+}
+
+//
+//   ---------------------------------------------------------------------------------------
+// -- XTime::leapsAt (const XTimeLeapTable *leaps, double *leapval, long mjdi, double mjdf) --
+//   ---------------------------------------------------------------------------------------
+//
+
+// Description:
+// Set *leapval to the leap seconds of table leaps at TT time
+// mjdi+mjdf; return 1 if that is in a leap second, else 0.
+int XTime::leapsAt (const XTimeLeapTable *leaps, double *leapval, long mjdi, double mjdf)
+{
+  const long *leapsmjd = leaps->mjd.data () ;
+  int i = leaps->num - 1 ;
   int m = 0 ;
   double x = (double) mjdi + mjdf - TAI2TT * SEC2DAY ;
   long j = (long) x ;
-  while ( ( j < LEAPSMJD[i] ) && i )
+  while ( ( j < leapsmjd[i] ) && i )
     i-- ;
-  if ( ( (x - LEAPSECS[i]*SEC2DAY) < LEAPSMJD[i] ) && i ) {
+  if ( ( (x - leaps->secs[i]*SEC2DAY) < leapsmjd[i] ) && i ) {
     i-- ;
-    if ( (LEAPSMJD[i+1] - x) <= SEC2DAY )
+    if ( (leapsmjd[i+1] - x) <= SEC2DAY )
       m = 1 ;
   }
-  *leapval = LEAPSECS[i] ;
+  *leapval = leaps->secs[i] ;
   return m ;
 }
 
+//
+//   --------------------------------------------------------------------------------------------------
+// -- XTime::makeSegments (const XTimeLeapTable *leaps, long mjdi, double mjdf, XTimeUTCSegments *seg) --
+//   --------------------------------------------------------------------------------------------------
+//
+
+// Description:
+// Fill seg with the UTC offset segments of table leaps for MJDref
+// mjdi+mjdf (TT).  Segment i holds the times with leap seconds
+// leaps->secs[i]: from TT time
+//   (leaps->mjd[i] - MJDref) * 86400 + leaps->secs[i] + TAI2TT
+// (where setmyleaps switches) and from UTC time
+//   (leaps->mjd[i] - MJDref) * 86400 + 1
+// (where set switches for UTC SECS, after the leap second).  The first
+// and last segments are open-ended, up to SEGLIMIT seconds.  The
+// nanosecond segments switch at the same times, rounded to the ns
+// (exact for an MJDref of whole ns), and cover all long long values.
+
+static const double SEGLIMIT = 1.0e12 ;    // Outer bound of the segments (s)
+static const double SEGMARGIN = 1.0e-3 ;   // Margin around the leap seconds (s)
+
+void XTime::makeSegments (const XTimeLeapTable *leaps, long mjdi, double mjdf,
+			  XTimeUTCSegments *seg)
+{
+  double ref, day ;
+  long long dayns ;
+  int i ;
+
+  leapsAt (leaps, &ref, mjdi, mjdf) ;
+  seg->leaps = leaps ;
+  seg->mjdrefi = mjdi ;
+  seg->mjdreff = mjdf ;
+  seg->refLeaps = ref ;
+  seg->num = leaps->num ;
+  seg->toUTC.resize (leaps->num) ;
+  seg->toTT.resize (leaps->num) ;
+  seg->toUTCNanos.resize (leaps->num) ;
+  seg->toTTNanos.resize (leaps->num) ;
+  for (i=0; i<leaps->num; i++) {
+    seg->toUTC[i].offset = ref - leaps->secs[i] ;
+    seg->toTT[i].offset = leaps->secs[i] - ref ;
+    seg->toUTCNanos[i].offset = llround ((ref - leaps->secs[i]) * 1.0e9) ;
+    seg->toTTNanos[i].offset = -seg->toUTCNanos[i].offset ;
+    if ( i ) {
+      day = ((leaps->mjd[i] - mjdi) - mjdf) * DAY2SEC ;
+      seg->toUTC[i].start = day + leaps->secs[i] + TAI2TT + SEGMARGIN ;
+      seg->toUTC[i-1].end = day + leaps->secs[i-1] + TAI2TT - SEGMARGIN ;
+      seg->toTT[i].start = day + 1.0 + SEGMARGIN ;
+      seg->toTT[i-1].end = day - SEGMARGIN ;
+      dayns = (leaps->mjd[i] - mjdi) * NSPERDAY - llround (mjdf * NSPERDAY) ;
+      seg->toUTCNanos[i].start = seg->toUTCNanos[i-1].end
+	= dayns + llround ((leaps->secs[i] + TAI2TT) * 1.0e9) ;
+      seg->toTTNanos[i].start = seg->toTTNanos[i-1].end = dayns + 1000000000LL ;
+    }
+  }
+  seg->toUTC[0].start = seg->toTT[0].start = -SEGLIMIT ;
+  seg->toUTC[i-1].end = seg->toTT[i-1].end = SEGLIMIT ;
+  seg->toUTCNanos[0].start = seg->toTTNanos[0].start = LLONG_MIN ;
+  seg->toUTCNanos[i-1].end = seg->toTTNanos[i-1].end = LLONG_MAX ;
+  return ;
+}
+
+//
+//   ------------------------------------------------------------------------------------------------------
+// -- XTime::convertSecs (const double *tin, double *tout, long n, int toUTC, const XTimeUTCSegments *seg) --
+//   ------------------------------------------------------------------------------------------------------
+//
+
+// Description:
+// Convert n times tin, in TT (or MET or TAI) seconds to UTC seconds if
+// toUTC, else from UTC to TT seconds, into tout, using segments seg
+// (default: utcSegments (), for the default MJDref).  Each time is
+// looked up in the segment of the previous time, or else by binary
+// search, and its offset added in the way set and get would, so that
+// the results are those of XTime to the bit; times inside a leap
+// second, or outside the segments, are converted by XTime itself,
+// with the table the segments were made from.
+// Times that are not finite give NaN.  Returns the number of times
+// converted by XTime.
+long XTime::convertSecs (const double *tin, double *tout, long n, int toUTC,
+			 const XTimeUTCSegments *seg)
+{
+  if ( seg == NULL )
+    seg = utcSegments () ;
+  const XTimeUTCSegment *s = toUTC ? seg->toUTC.data () : seg->toTT.data () ;
+  TimeSys tsIn = toUTC ? TT : UTC ;
+  TimeSys tsOut = toUTC ? UTC : TT ;
+  double mjdf = seg->mjdreff ;
+  double ref = seg->refLeaps ;
+  XTime T ;
+  T.table = seg->leaps ;
+  T.set (0.0, TT, SECS, seg->mjdrefi, seg->mjdreff) ;
+  long slow = 0 ;
+  int i = 0 ;
+
+  for (long k=0; k<n; k++) {
+    double t = tin[k] ;
+    if ( !( ( t >= s[i].start ) && ( t < s[i].end ) ) ) {
+      // Last segment that starts at or before t (without branches)
+      i = 0 ;
+      for (int len=seg->num; len>1; len-=len/2)
+	i = ( s[i + len/2].start <= t ) ? i + len/2 : i ;
+      if ( !( ( t >= s[i].start ) && ( t < s[i].end ) ) ) {
+	slow++ ;
+	if ( isfinite (t) ) {
+	  T.set (t, tsIn, SECS) ;
+	  tout[k] = T.get (tsOut, SECS) ;
+	}
+	else
+	  tout[k] = NAN ;
+	continue ;
+      }
+    }
+    // For UTC, in the order of getUTC: - myLeaps + refLeaps
+    if ( toUTC )
+      tout[k] = storedSecs (t, 0.0, mjdf) - ( ref - s[i].offset ) + ref ;
+    else
+      tout[k] = storedSecs (t, s[i].offset, mjdf) ;
+  }
+  XTSTAT_ADD (XTS_SEGMENT_FAST, n - slow) ;
+  XTSTAT_ADD (XTS_SEGMENT_SLOW, slow) ;
+  return slow ;
+}
+
+//
+//   -------------------------------------------------------------------------------------------------------------
+// -- XTime::convertNanos (const long long *tin, long long *tout, long n, int toUTC, const XTimeUTCSegments *seg) --
+//   -------------------------------------------------------------------------------------------------------------
+//
+
+// Description:
+// Convert n times tin, in TT (or MET or TAI) nanoseconds since MJDref
+// to UTC nanoseconds if toUTC, else from UTC to TT nanoseconds, into
+// tout, using segments seg (default: utcSegments (), for the default
+// MJDref), in integer arithmetic only: exact, with the leap seconds
+// where XTime puts them (a UTC time in a leap second is the one
+// second after it, repeated, as for UTC SECS).  Each time is looked up
+// in the segment of the previous time, or else by binary search.
+void XTime::convertNanos (const long long *tin, long long *tout, long n, int toUTC,
+			  const XTimeUTCSegments *seg)
+{
+  if ( seg == NULL )
+    seg = utcSegments () ;
+  const XTimeNanoSegment *s = toUTC ? seg->toUTCNanos.data () : seg->toTTNanos.data () ;
+  int i = 0 ;
+
+  for (long k=0; k<n; k++) {
+    long long t = tin[k] ;
+    if ( !( ( t >= s[i].start ) && ( t < s[i].end ) ) ) {
+      // Last segment that starts at or before t (without branches)
+      i = 0 ;
+      for (int len=seg->num; len>1; len-=len/2)
+	i = ( s[i + len/2].start <= t ) ? i + len/2 : i ;
+    }
+    tout[k] = t + s[i].offset ;
+  }
+  return ;
+}
+
+//
+//   -----------------------------------
+// -- XTimeContext::XTimeContext (void) --
+//   -----------------------------------
+//
+
+// Description:
+// Constructor: the global context, with the leap second table that
+// XTime keeps current and the default MJDref (1998.0 TT).  There is
+// one, returned by global (); other instances behave the same.
+XTimeContext::XTimeContext (void)
+  : leaps (NULL), mjdrefi (XTime::MJDREFint), mjdreff (XTime::MJDREFfr),
+    refLeaps (XTime::REFLEAPS)
+{
+}
+
+//
+//   ----------------------------------------------------------------------------------
+// -- XTimeContext::XTimeContext (const XTimeLeapTable &table, long mjdi, double mjdf) --
+//   ----------------------------------------------------------------------------------
+//
+
+// Description:
+// Constructor: a context with a copy of leap second table table and
+// default MJDref mjdi+mjdf (TT; default 0, for 50814.0, 1998.0 TT).
+// The UTC segments of the copy are made for that MJDref, once.  A
+// table without entries cannot be used; the context then is the same
+// as the global one.
+XTimeContext::XTimeContext (const XTimeLeapTable &table, long mjdi, double mjdf)
+  : leaps (NULL), mjdrefi (XTime::MJDREFint), mjdreff (XTime::MJDREFfr),
+    refLeaps (XTime::REFLEAPS)
+{
+  if ( table.num <= 0 )
+    return ;
+  if ( mjdi > 1 ) {
+    mjdrefi = mjdi ;
+    mjdreff = mjdf ;
+  }
+  leaps = new XTimeLeapTable (table) ;
+  XTime::makeSegments (leaps, mjdrefi, mjdreff, &leaps->segments) ;
+  refLeaps = leaps->segments.refLeaps ;
+}
+
+//
+//   ------------------------------------
+// -- XTimeContext::~XTimeContext (void) --
+//   ------------------------------------
+//
+
+// Description:
+// Destructor: free the context's own table.
+XTimeContext::~XTimeContext (void)
+{
+  delete leaps ;
+}
+
+//
+//   -----------------------------
+// -- XTimeContext::global (void) --
+//   -----------------------------
+//
+
+// Description:
+// Return the global context: the leap second table that XTime keeps
+// current from the leap seconds file, and the default MJDref.
+const XTimeContext& XTimeContext::global (void)
+{
+  static const XTimeContext context ;
+  return context ;
+}
+
 //
 //   ---------------------------------------------------------------------------
 // -- XTime::set (double tt, TimeSys ts, TimeFormat tf, long mjdi, double mjdf) --
@@ -214,13 +703,21 @@ void XTime::set (long tti, double ttf, TimeSys ts, TimeFormat tf,
   double total, x ;
   long j=0, k ;
   int i ;
+  const XTimeLeapTable *leaps ;
+  XTTRACE_SPAN ("XTime::set", "XTime") ;
   leapflag = 0 ;
+  if ( tf <= MJD )
+    XTSTAT_COUNT (XTS_SET_SECS + tf) ;
+  if ( ts == UTC )
+    XTSTAT_COUNT (XTS_SET_UTC) ;
 
   // First, set the MJDREF, if specified
   if ( mjdi > 1 ) {
     switch (ts) {
     case UTC: {
-      XTime mt (mjdi, mjdf, ts) ;
+      XTime mt ;
+      mt.table = table ;
+      mt.set (mjdi, mjdf, ts) ;
       mt.mjd (&mjdi, &mjdf) ;
       break ;
     }
@@ -254,17 +751,17 @@ void XTime::set (long tti, double ttf, TimeSys ts, TimeFormat tf,
     // Build up the corrections to TT, depending on ts
     switch (ts) {
     case UTC:
-      i = NUMLEAPSECS - 1 ;
-      while ( ( k < LEAPSMJD[i] ) && i ) {
+      leaps = myTable () ;
+      i = leaps->num - 1 ;
+      while ( ( k < leaps->mjd[i] ) && i ) {
 	i-- ;
       }
-      if ( ( i < NUMLEAPSECS-1 ) && ( k+1 == LEAPSMJD[i+1] ) &&
-          ( (LEAPSMJD[i+1] - k + x + timeZero) < SEC2DAY  ) && i ) {
-	i-- ;
+      // Second 60 of the day before a leap second is the leap second
+      if ( ( i < leaps->num-1 ) && ( k+1 == leaps->mjd[i+1] ) &&
+	   ( x + timeZero >= 1.0 ) && ( x + timeZero < 1.0 + SEC2DAY ) )
 	leapflag = 1 ;
-      }
-      total += LEAPSECS[i] ;
-      myLeaps = LEAPSECS[i] ;
+      total += leaps->secs[i] ;
+      myLeaps = leaps->secs[i] ;
     case TAI:
       total += TAI2TT ;
     case TT:
@@ -288,17 +785,18 @@ void XTime::set (long tti, double ttf, TimeSys ts, TimeFormat tf,
       // First, subtract the leap seconds for the reference
       total -= refLeaps ;
       // Then add the leap seconds for the time itself
-      i = NUMLEAPSECS - 1 ;
+      leaps = myTable () ;
+      i = leaps->num - 1 ;
       j = (long) (k + x + timeZero) ;
-      while ( ( j < LEAPSMJD[i] ) && i ) {
+      while ( ( j < leaps->mjd[i] ) && i ) {
 	i-- ;
       }
-      if ( ( (k + x + timeZero - LEAPSMJD[i]) < SEC2DAY  ) && i ) {
+      if ( ( (k + x + timeZero - leaps->mjd[i]) < SEC2DAY  ) && i ) {
 	i-- ;
 	leapflag = 1 ;
       }
-      total += LEAPSECS[i] ;
-      myLeaps = LEAPSECS[i] ;
+      total += leaps->secs[i] ;
+      myLeaps = leaps->secs[i] ;
     case TAI:
     case TT:
     case MET:
@@ -323,10 +821,64 @@ void XTime::set (long tti, double ttf, TimeSys ts, TimeFormat tf,
   // The leap seconds value and flag have already been set for UTC
   if ( ts != UTC )
     leapflag = setmyleaps (&myLeaps, MJDint, MJDfr+timeZero) ;
+  if ( leapflag )
+    XTSTAT_COUNT (XTS_LEAP_SECOND) ;
 
   return ;
 }
 
+//
+//   --------------------------------------------
+// -- XTime::setNanos (long long ns, TimeSys ts) --
+//   --------------------------------------------
+//
+
+// Description:
+// Set the time to ns nanoseconds since MJDref in time system ts
+// (default: TT; MET and TAI are the same; UTC as set (x, UTC, SECS)),
+// in integer arithmetic: whole days and nanoseconds of the day; only
+// the fraction of the day is rounded when it is stored.
+void XTime::setNanos (long long ns, TimeSys ts)
+{
+  const long long NSPERSEC = 1000000000LL ;
+  long long days, rem ;
+  const XTimeLeapTable *leaps ;
+  int i ;
+
+  leapflag = 0 ;
+  if ( ts == UTC ) {
+    // The leap seconds at UTC MJDref+ns+timeZero, as set finds them for SECS
+    leaps = myTable () ;
+    long long utc = ns + MJDrefint * NSPERDAY + llround ((MJDreffr + timeZero) * NSPERDAY) ;
+    i = leaps->num - 1 ;
+    while ( ( utc < leaps->mjd[i] * NSPERDAY ) && i )
+      i-- ;
+    if ( ( utc - leaps->mjd[i] * NSPERDAY < NSPERSEC ) && i ) {
+      i-- ;
+      leapflag = 1 ;
+    }
+    myLeaps = leaps->secs[i] ;
+    ns += llround ((myLeaps - refLeaps) * NSPERSEC) ;
+  }
+  days = ns / NSPERDAY ;
+  rem = ns % NSPERDAY ;
+  if ( rem < 0 ) {
+    rem += NSPERDAY ;
+    days-- ;
+  }
+  MJDint = MJDrefint + days ;
+  MJDfr = MJDreffr + (double) rem / NSPERDAY ;
+  if ( MJDfr >= 1.0 ) {
+    MJDfr-- ;
+    MJDint++ ;
+  }
+  if ( ts != UTC )
+    leapflag = setmyleaps (&myLeaps, MJDint, MJDfr+timeZero) ;
+  if ( leapflag )
+    XTSTAT_COUNT (XTS_LEAP_SECOND) ;
+  return ;
+}
+
 //
 //   ----------------------------------------------------------------------------
 // -- XTime::set (char* date, TimeSys ts, TimeFormat tf, long mjdi, double mjdf) --
@@ -337,58 +889,69 @@ void XTime::set (long tti, double ttf, TimeSys ts, TimeFormat tf,
 // General set function from a date string.
 // Allows specification of DATE, CALDATE, or FITS formats.
 // The defaults for ts, tf, and dec are UTC, DATE, and 0.
+// Returns 0 on success, 1 if date could not be parsed (unknown
+// format, missing fields, or bad month name), in which case the
+// object is left unchanged.
 // This method calls
 // XTime::set (long, double, TimeSys, TimeFormat, long, double)
-void XTime::set (const char* date, TimeSys ts, TimeFormat tf,
-		 long mjdi, double mjdf)
+int XTime::set (const char* date, TimeSys ts, TimeFormat tf,
+		long mjdi, double mjdf)
 {
   long year=0, day=0, hour=0, minute=0 ;
   double second=0.0 ;
   int n ;
   int m = 0 ;
   char mn[4] ;
+  const int *dm ;
 
+  XTSTAT_TIME (XTH_SET_DATE) ;
+  XTTRACE_SPAN ("XTime::set(date)", "XTime") ;
+  if ( ( tf >= DATE ) && ( tf <= FITS ) )
+    XTSTAT_COUNT (XTS_SET_DATE + tf - DATE) ;
   switch (tf) {
   case DATE:
     n = sscanf (date, "%ld:%ld:%ld:%ld:%lg", &year, &day, &hour, &minute, &second) ;
-    if ( n != 5 )
-      return ;
+    if ( n != 5 ) {
+      XTSTAT_COUNT (XTS_DATE_REJECTED) ;
+      return 1 ;
+    }
     break ;
   case CALDATE:
     n = sscanf (date, "%ld%c%c%c%ld at %ld:%ld:%lg",
     &year, mn, mn+1, mn+2, &day, &hour, &minute, &second) ;
-    if ( n != 8 )
-      return ;
-    if ( year%4 )
-      daymonth[1] = 28 ;
-    else
-      daymonth[1] = 29 ;
+    if ( n != 8 ) {
+      XTSTAT_COUNT (XTS_DATE_REJECTED) ;
+      return 1 ;
+    }
+    dm = daymonth[year%4 == 0] ;
     mn[0] = toupper(mn[0]) ;
     mn[1] = tolower(mn[1]) ;
     mn[2] = tolower(mn[2]) ;
     mn[3] = 0 ;
     while ( strcmp(mn, month[m]) ) {
-      if ( m > 11 )
-	return ;
-      day += daymonth[m++] ;
+      day += dm[m++] ;
+      if ( m > 11 ) {
+	XTSTAT_COUNT (XTS_DATE_REJECTED) ;
+	return 1 ;
+      }
     }
     break ;
   case FITS: {
     n = sscanf (date, "%ld-%d-%ldT%ld:%ld:%lg",
 		&year, &m, &day, &hour, &minute, &second) ;
-    if ( ( n != 6 ) && ( n != 3 ) )
-      return ;
-    if ( year%4 )
-      daymonth[1] = 28 ;
-    else
-      daymonth[1] = 29 ;
+    if ( ( n != 6 ) && ( n != 3 ) ) {
+      XTSTAT_COUNT (XTS_DATE_REJECTED) ;
+      return 1 ;
+    }
+    dm = daymonth[year%4 == 0] ;
     m-- ;
     for (int i=0; i<m; i++)
-      day += daymonth[i] ;
+      day += dm[i] ;
     break ;
   }
   default:
-    return ;
+    XTSTAT_COUNT (XTS_DATE_REJECTED) ;
+    return 1 ;
   }
 
   day += (year - 1972) * 365 - 1 ;
@@ -399,7 +962,7 @@ void XTime::set (const char* date, TimeSys ts, TimeFormat tf,
 
   set (day, second, ts, MJD, mjdi, mjdf) ;
 
-  return ;
+  return 0 ;
 }
 
 //
@@ -417,13 +980,10 @@ const char* XTime::monDay (const char* date, TimeFormat tf) {
 
   strcpy (d, date) ;
   sscanf (d, "%d:%d", &year, &day) ;
-  if ( year%4 )
-    daymonth[1] = 28 ;
-  else
-    daymonth[1] = 29 ;
+  const int *dm = daymonth[year%4 == 0] ;
 
-  while ( day > daymonth[m] ) {
-    day -= daymonth[m] ;
+  while ( day > dm[m] ) {
+    day -= dm[m] ;
     m++ ;
   }
   if ( tf == CALDATE ) {
@@ -452,6 +1012,9 @@ const char* XTime::monDay (const char* date, TimeFormat tf) {
 double XTime::get (TimeSys ts, TimeFormat tf) const {
   double tt=timeZero ;
   
+  XTTRACE_SPAN ("XTime::get", "XTime") ;
+  if ( tf <= MJD )
+    XTSTAT_COUNT (XTS_GET_SECS + tf) ;
   switch (tf) {
   case SECS:
     switch (ts) {
@@ -486,6 +1049,82 @@ double XTime::get (TimeSys ts, TimeFormat tf) const {
   return tt ;
 }
 
+//
+//   ------------------------------
+// -- XTime::getNanos (TimeSys ts) --
+//   ------------------------------
+//
+
+// Description:
+// Return the time in nanoseconds since MJDref, rounded to the ns, in
+// time system ts (default: TT; MET and TAI are the same; UTC as
+// get (UTC, SECS)).  The whole days count exactly; only the fraction
+// of the day is rounded.
+long long XTime::getNanos (TimeSys ts) const {
+  long long ns = (MJDint - MJDrefint) * NSPERDAY
+    + llround (((MJDfr - MJDreffr) + timeZero) * NSPERDAY) ;
+  if ( ts == UTC )
+    ns -= llround ((myLeaps - refLeaps) * 1.0e9) ;
+  return ns ;
+}
+
+//
+//   --------------------------------------------------------
+// -- XTime::getHiLo (double *lo, TimeSys ts, TimeFormat tf) --
+//   --------------------------------------------------------
+//
+
+// Description:
+// Return the time as get (ts, tf) does, for SECS, JD, or MJD, but as a
+// double-double: the nearest double is returned, and the rest in lo,
+// so that hi+lo is the time to about 1e-30 of its value.  The parts
+// the time is kept in (integer and fractional day, time zero) are
+// added without rounding (two-sum), and so are the corrections for
+// TAI and UTC, split into a double and its remainder (by fma).  Near
+// the present epoch, a JD as a single double is good to about 20 us;
+// hi+lo keeps the full precision of the time (in MJD, to better than
+// a ns).  The default for ts is TT, for tf MJD.
+double XTime::getHiLo (double *lo, TimeSys ts, TimeFormat tf) const
+{
+  double hi, secs, corr ;
+
+  *lo = 0.0 ;
+  switch (tf) {
+  case SECS:
+    hi = (double) ( MJDint - MJDrefint ) ;
+    ddAdd (&hi, lo, MJDfr) ;
+    ddAdd (&hi, lo, -MJDreffr) ;
+    ddAdd (&hi, lo, timeZero) ;
+    // Days to seconds: the error of the product of hi, by fma
+    secs = hi * DAY2SEC ;
+    *lo = *lo * DAY2SEC + fma (hi, DAY2SEC, -secs) ;
+    hi = secs ;
+    if ( ts == UTC )
+      ddAdd (&hi, lo, refLeaps - myLeaps) ;
+    break ;
+  case JD:
+  case MJD:
+    hi = (double) MJDint ;
+    if ( tf == JD )
+      ddAdd (&hi, lo, MJD0) ;
+    ddAdd (&hi, lo, MJDfr) ;
+    ddAdd (&hi, lo, timeZero) ;
+    if ( ( ts == UTC ) || ( ts == TAI ) ) {
+      // -secs/DAY2SEC as corr and the exact remainder of the division
+      secs = TAI2TT + ( ( ts == UTC ) ? myLeaps : 0.0 ) ;
+      corr = -secs / DAY2SEC ;
+      ddAdd (&hi, lo, corr) ;
+      ddAdd (&hi, lo, -fma (corr, DAY2SEC, secs) / DAY2SEC) ;
+    }
+    break ;
+  default:
+    return 0.0 ;
+  }
+  secs = hi + *lo ;
+  *lo -= secs - hi ;
+  return secs ;
+}
+
 //
 //   ---------------------------------------------------
 // -- XTime::mjd (long *mjdi, double *mjdf, TimeSys ts) --
@@ -538,17 +1177,18 @@ double XTime::UTmjd (long *mjdi, double *mjdf) const {
 }
 
 //
-//   -----------------------------------------------------
-// -- XTime::getDate (TimeSys ts, TimeFormat tf, int dec) --
-//   -----------------------------------------------------
+//   -------------------------------------------------------------------------
+// -- XTime::dayTime (TimeSys ts, int dec, int*, int*, int*, int*, double*) --
+//   -------------------------------------------------------------------------
 //
 
 // Description:
-// Generalized date string return function.
-// Allows specification of DATE, CALDATE, or FITS formats
-// and the number of decimals in the seconds field.
-// The defaults for ts, tf, and dec are UTC, DATE, and 0.
-const char* XTime::getDate (TimeSys ts, TimeFormat tf, int dec) {
+// Divide the time into year/day/hour/minute/second in time system ts,
+// rounded to dec decimals in the seconds field as for getDate (but
+// second itself is not rounded).  Day is the day of the year (1-366).
+// Return the MJD of the day.
+long XTime::dayTime (TimeSys ts, int dec, int *year, int *day,
+		     int *hour, int *minute, double *second) const {
   long k ;
   double x ;
 
@@ -566,50 +1206,108 @@ const char* XTime::getDate (TimeSys ts, TimeFormat tf, int dec) {
   }
 
   // Divide into year/day/hour/minute/second
-  int year, day, hour, minute ;
-  double second ;
   double dsec ;
   dsec = 0.5 * pow(10.0, (double) -dec) ;
 
   // First add dsec; later subtract it; this is to avoid rounding 59.9999 to 60.0
-  day = k - MJD1972 ;
-  second = x * DAY2SEC + dsec ;
+  *day = k - MJD1972 ;
+  *second = x * DAY2SEC + dsec ;
   int i = 0 ;
-  year = 1972 ;
+  *year = 1972 ;
   if ( ( ts == UTC ) && leapflag ) {
-    second++ ;
-    hour = (int) second / 3600 ;
-    if ( hour > 23 ) hour-- ;
-    second -= hour * 3600.0 ;
-    minute = (int) second / 60 ;
-    if ( minute > 59 ) minute-- ;
-    second -= minute * 60.0 ;
+    (*second)++ ;
+    *hour = (int) *second / 3600 ;
+    if ( *hour > 23 ) (*hour)-- ;
+    *second -= *hour * 3600.0 ;
+    *minute = (int) *second / 60 ;
+    if ( *minute > 59 ) (*minute)-- ;
+    *second -= *minute * 60.0 ;
   }
   else {
-    hour = (int) second / 3600 ;
-    second -= hour * 3600.0 ;
-    minute = (int) second / 60 ;
-    second -= minute * 60.0 ;
+    *hour = (int) *second / 3600 ;
+    *second -= *hour * 3600.0 ;
+    *minute = (int) *second / 60 ;
+    *second -= *minute * 60.0 ;
   }
-  if ( hour > 23 ) {
-    hour -= 24 ;
-    day++ ;
+  if ( *hour > 23 ) {
+    *hour -= 24 ;
+    (*day)++ ;
   }
-  second -= dsec ;
-  if ( second < 0.0 ) second = 0.0 ;
-  day++ ;
-  while ( day > 365 ) {
+  *second -= dsec ;
+  if ( *second < 0.0 ) *second = 0.0 ;
+  k = MJD1972 + *day ;
+  (*day)++ ;
+  while ( *day > 365 ) {
     if ( !i ) {
-      if ( day == 366 )
+      if ( *day == 366 )
 	break ;
       else
-	day-- ;
+	(*day)-- ;
     }
-    day -= 365 ;
-    year++ ;
+    *day -= 365 ;
+    (*year)++ ;
     i = (i+1)%4 ;
   }
 
+  return k ;
+}
+
+//
+//   ---------------------------------------------------------------------
+// -- XTime::getFields (int*, int*, int*, int*, int*, int*, double*, ...) --
+//   ---------------------------------------------------------------------
+//
+
+// Description:
+// Return the calendar fields of the time in time system ts:
+// year, day of year (1-366), month (1-12), day of month (1-31),
+// hour, minute, and second, with second rounded to dec decimals
+// as in the string returned by getDate.
+// The defaults for ts and dec are UTC and 0.
+// Return the MJD of the day (e.g. for the day of the week).
+long XTime::getFields (int *year, int *yday, int *month, int *mday,
+		       int *hour, int *minute, double *second,
+		       TimeSys ts, int dec) const {
+  int m = 0 ;
+  double p = pow(10.0, (double) dec) ;
+  long k = dayTime (ts, dec, year, yday, hour, minute, second) ;
+
+  *second = floor (*second * p + 0.5) / p ;
+  const int *dm = daymonth[*year%4 == 0] ;
+  *mday = *yday ;
+  while ( *mday > dm[m] ) {
+    *mday -= dm[m] ;
+    m++ ;
+  }
+  *month = m + 1 ;
+
+  return k ;
+}
+
+//
+//   -----------------------------------------------------
+// -- XTime::getDate (TimeSys ts, TimeFormat tf, int dec) --
+//   -----------------------------------------------------
+//
+
+// Description:
+// Generalized date string return function.
+// Allows specification of DATE, CALDATE, or FITS formats
+// and the number of decimals in the seconds field.
+// The defaults for ts, tf, and dec are UTC, DATE, and 0.
+const char* XTime::getDate (TimeSys ts, TimeFormat tf, int dec) {
+  int year, day, hour, minute ;
+  double second ;
+
+  XTSTAT_TIME (XTH_GETDATE) ;
+  XTTRACE_SPAN ("XTime::getDate", "XTime") ;
+  if ( ( tf >= DATE ) && ( tf <= FITS ) )
+    XTSTAT_COUNT (XTS_GETDATE_DATE + tf - DATE) ;
+  else
+    XTSTAT_COUNT (XTS_GETDATE_DATE) ;
+
+  dayTime (ts, dec, &year, &day, &hour, &minute, &second) ;
+
   char formt[32], f2[10] ;
   if ( dec ) {
     strcpy (formt, "%4d:%03d:%02d:%02d:%0") ;
@@ -740,6 +1438,7 @@ void XTRList::printListCal (void) {
 // Copy constructor for a new TR list
 XTRList::XTRList (const XTRList &trl)
 {
+  XTSTAT_CALL (XTA_XTRLIST_NEW) ;
   numXTRs = trl.numXTRs ;
   listRange = trl.listRange ;
   empty = trl.empty ;
@@ -759,6 +1458,7 @@ XTRList::XTRList (const XTRList &trl)
 // Copy operator for a TR list
 XTRList& XTRList::operator= (const XTRList &trl)
 {
+  XTSTAT_CALL (XTA_XTRLIST_ASSIGN) ;
   delete [] tr ;
   numXTRs = trl.numXTRs ;
   listRange = trl.listRange ;
@@ -780,13 +1480,14 @@ XTRList& XTRList::operator= (const XTRList &trl)
 // Construct a new TR list by "AND"ing two existing lists
 XTRList::XTRList (const XTRList &trl1, const XTRList &trl2)
   : numXTRs (1), empty (1), tr (0) {
+  XTSTAT_CALL (XTA_XTRLIST_NEW) ;
 
 //  Trivial cases: if one of them is empty, the result is empty
 
   if ( trl1.isEmpty() || trl2.isEmpty() ) {
     numXTRs = 1 ;
     empty = 1 ;
-    tr = new XTimeRange () ;
+    tr = new XTimeRange[1] ;
     listRange = *tr ;
     return ;
   }
@@ -838,6 +1539,52 @@ XTRList::XTRList (const XTRList &trl1, const XTRList &trl2)
   return ;
 }
 
+//
+//   ------------------------------------------
+// -- XTRList::XTRList (double*, double*, int) --
+//   ------------------------------------------
+//
+
+// Description:
+// Construct a TR list from n ranges given as MET start and stop
+// times (e.g., a GTI table).  Ranges that are in time order and do
+// not touch (the normal case for GTIs) are stored directly, which
+// takes linear time; any others are ORed in with orRange.
+// Empty ranges are ignored.
+XTRList::XTRList (const double *tstart, const double *tstop, int n)
+  : numXTRs (1), empty (1) {
+  XTSTAT_CALL (XTA_XTRLIST_NEW) ;
+  int i ;
+
+  tr = new XTimeRange[( n > 0 ) ? n : 1] ;
+
+//  Store the ranges while they are in order
+
+  for (i=0; i<n; i++) {
+    XTimeRange T (tstart[i], tstop[i]) ;
+    if ( T.isEmpty () )
+      continue ;
+    if ( empty ) {
+      tr[0] = T ;
+      empty = 0 ;
+    }
+    else if ( tstart[i] > tr[numXTRs-1].METStop () )
+      tr[numXTRs++] = T ;
+    else
+      break ;
+  }
+  if ( empty )
+    listRange = *tr ;
+  else
+    setListRange () ;
+
+//  OR in the rest
+
+  for (; i<n; i++)
+    orRange (XTimeRange (tstart[i], tstop[i])) ;
+  return ;
+}
+
 //
 //   -----------------------------
 // -- XTRList::isInRange (XTime&) --
@@ -868,6 +1615,41 @@ int XTRList::isInRange (double t) const {
   return 1 ;
 }
 
+//
+//   ---------------------
+// -- XTRList::scanLength --
+//   ---------------------
+//
+
+// Description:
+// Return the number of ranges isInRange (t) examines: up to and
+// including the one <t> falls in, or all of them.
+int XTRList::scanLength (double t) const {
+  for (int i=0;i<numXTRs;i++)
+    if ( !tr[i].isInRange (t) )
+      return i+1 ;
+  return numXTRs ;
+}
+
+//
+//   -----------------------
+// -- XTRList::bytesTouched --
+//   -----------------------
+//
+
+// Description:
+// Return the bytes of memory isInRange (t) reads from the array of
+// ranges, counted as the cache lines of <line> bytes spanned by the
+// ranges it examines.
+long XTRList::bytesTouched (double t, int line) const {
+  int n = scanLength (t) ;
+  if ( ( n < 1 ) || ( line < 1 ) )
+    return 0 ;
+  std::uintptr_t first = (std::uintptr_t) tr / line ;
+  std::uintptr_t last = ( (std::uintptr_t) (tr + n) - 1 ) / line ;
+  return (long) ( last - first + 1 ) * line ;
+}
+
 //
 //   ----------------------------
 // -- XTRList::getRange (XTime&) --
@@ -923,6 +1705,7 @@ double XTRList::totalTime (void) const {
 // Description:
 // "OR" in another XTime Range List
 void XTRList::orList (const XTRList &trl) {
+  XTSTAT_CALL (XTA_OR_LIST) ;
 
 //  Do nothing if trl is empty
 
@@ -960,6 +1743,7 @@ void XTRList::orList (const XTRList &trl) {
 // Description:
 // Negate a XTime Range List over a specified time range
 void XTRList::notList (const XTimeRange &T) {
+  XTSTAT_CALL (XTA_NOT_LIST) ;
 
 //  If the list was empty, the answer is just T ...
 
@@ -1004,6 +1788,7 @@ void XTRList::notList (const XTimeRange &T) {
 // Description:
 // "AND" in an extra XTime Range
 void XTRList::andRange (const XTimeRange &T) {
+  XTSTAT_CALL (XTA_AND_RANGE) ;
   int startin=0, stopin=0 ;
   int startafter=0, stopafter=0 ;
   int zap=0 ;
@@ -1127,6 +1912,7 @@ void XTRList::andRange (const XTimeRange &T) {
 // Description:
 // "OR" in an extra XTime Range
 void XTRList::orRange (const XTimeRange &T) {
+  XTSTAT_CALL (XTA_OR_RANGE) ;
   int startin=0, stopin=0 ;
   int startafter=0, stopafter=0 ;
   int before=0, after=0, between=0, straddle=0 ;
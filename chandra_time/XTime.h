@@ -55,9 +55,11 @@
 //
 // cout << "Time : " << t.TTDate() << " or " << t.TTCalDate() << endl ;
 //
-// Leap seconds are taken from tai-utc.dat.  If not available:
-// Included leap seconds: 1972 through 1999 (leap seconds 10
-// through 32).
+// Leap seconds are taken from the table compiled in from tai-utc.dat
+// (XTimeLeaps.h), or from $TIMING_DIR/tai-utc.dat or
+// $ASC_DATA/tai-utc.dat if that file is newer than the table.
+// An XTimeContext holds a leap second table of its own and a default
+// MJDref; XTime objects made in a context use those instead.
 //
 // .VERSION $Revision: 1.2 $
 //
@@ -67,7 +69,148 @@
 #ifndef XTIME_H
 #define XTIME_H
 #include <time.h>
+#include <atomic>
+#include <vector>
+#include "XTimeStats.h"
 
+struct XTimeLeapTable ;
+
+//
+//   -----------------
+// -- XTimeUTCSegment --
+//   -----------------
+//
+
+// Description:
+// One interval of constant TAI-UTC: times t in seconds since MJDref
+// with start <= t < end convert by adding offset (seconds).
+struct XTimeUTCSegment {
+  double start ;                       // First time of the segment
+  double end ;                         // First time after the segment
+  double offset ;                      // Total offset to the other system
+} ;
+
+//
+//   -----------------
+// -- XTimeNanoSegment --
+//   -----------------
+//
+
+// Description:
+// One interval of constant TAI-UTC in integer nanoseconds since
+// MJDref: times t with start <= t < end convert by adding offset (ns).
+struct XTimeNanoSegment {
+  long long start ;                    // First time of the segment
+  long long end ;                      // First time after the segment
+  long long offset ;                   // Total offset to the other system
+} ;
+
+//
+//   ------------------
+// -- XTimeUTCSegments --
+//   ------------------
+//
+
+// Description:
+// The UTC offsets of a leap second table for one MJDref (TT), as
+// segments, one per leap second: toUTC by TT seconds (UTC = TT +
+// offset) and toTT by UTC seconds (TT = UTC + offset), both as XTime
+// computes them for SECS.  The gaps between segments are the leap
+// seconds themselves, widened by a millisecond on either side, where
+// XTime::convertSecs falls back to XTime (with table leaps).  The
+// same in integer nanoseconds, for XTime::convertNanos: toUTCNanos and
+// toTTNanos, without gaps, since integers convert exactly.
+struct XTimeUTCSegments {
+  const XTimeLeapTable *leaps ;        // Table the segments were made from
+  long   mjdrefi ;                     // MJDref (integer part, TT)
+  double mjdreff ;                     // MJDref (fractional part, TT)
+  double refLeaps ;                    // Leap seconds at MJDref
+  int    num ;                         // Number of segments
+  std::vector<XTimeUTCSegment> toUTC ; // By TT seconds
+  std::vector<XTimeUTCSegment> toTT ;  // By UTC seconds
+  std::vector<XTimeNanoSegment> toUTCNanos ;  // By TT nanoseconds
+  std::vector<XTimeNanoSegment> toTTNanos ;   // By UTC nanoseconds
+} ;
+
+//
+//   ----------------
+// -- XTimeLeapTable --
+//   ----------------
+//
+
+// Description:
+// A leap second table, of any length, and the file it was read from.
+// A table is not changed once it is in use (XTime::LEAPS): a refresh
+// builds a new one and swaps it in, and the old one is kept for
+// conversions that may still be using it.
+struct XTimeLeapTable {
+  int    num = 0 ;                     // Number of leap seconds
+  std::vector<long> mjd ;              // Leap second dates (UTC MJD)
+  std::vector<double> secs ;           // TAI-UTC from those dates
+  char   file[256] = "" ;              // File they were read from ("" if built in)
+  time_t mtime = 0 ;                   // Modification time of the source
+  long   size = 0 ;                    // Size of the file
+  long   dev = 0 ;                     // Device and inode of the file
+  long   ino = 0 ;
+  XTimeUTCSegments segments ;          // UTC offsets for the default MJDref
+} ;
+
+//
+//   --------------
+// -- XTimeContext --
+//   --------------
+//
+
+// Description:
+// A time context: a leap second table and the default MJDref (TT) of
+// the XTime objects made in it.  The global context (global ()) uses
+// the table that XTime keeps current from the leap seconds file, and
+// MJDref 1998.0 (TT); this is what XTime objects made without a
+// context use.  Any other context owns a copy of the table it was
+// made from, which is never refreshed, with its UTC segments for the
+// context's MJDref, built once by the constructor.  Contexts with
+// different tables (e.g., the official one and one with a predicted
+// leap second) can be used side by side, by any number of threads.
+// A context must outlive the XTime objects made in it; it cannot be
+// copied.
+class XTimeContext {
+
+  friend class XTime ;
+
+//*  Private attributes
+
+  XTimeLeapTable *leaps ;              // Own table (NULL for the global table)
+  long   mjdrefi ;                     // Default MJDref (integer part, TT)
+  double mjdreff ;                     // Default MJDref (fractional part, TT)
+  double refLeaps ;                    // Leap seconds at the default MJDref
+
+//*  Private methods (not copied)
+
+  XTimeContext (const XTimeContext &) ;
+  XTimeContext& operator= (const XTimeContext &) ;
+
+//*  Public methods
+
+ public:
+
+//*    Constructors
+
+  XTimeContext (void) ;
+  XTimeContext (const XTimeLeapTable &table, long mjdi=0, double mjdf=0.0) ;
+
+//*    Destructor
+
+  ~XTimeContext (void) ;
+
+//*    Get methods
+
+  static const XTimeContext& global (void) ;
+  int isGlobal (void) const ;
+  const XTimeLeapTable* leapTable (void) const ;
+  const XTimeUTCSegments* utcSegments (void) const ;
+  double mjdRef (long *mjdi, double *mjdf) const ;
+  double refLeapSecs (void) const ;
+} ;
 
 //
 //   ---------
@@ -77,6 +220,8 @@
 
 class XTime {
 
+  friend class XTimeContext ;
+
 //*  Private attributes
  
   long   MJDint      ;               // Integer part of time
@@ -88,6 +233,7 @@ class XTime {
   int    leapflag    ;               // Indicator whether we are in a leap second
   double myLeaps     ;               // Leap seconds at this time
   double refLeaps    ;               // Leap seconds at reference epoch
+  const XTimeLeapTable *table ;      // Leap second table of the context (NULL: global)
 
 //*  Static attributes
 
@@ -95,15 +241,18 @@ class XTime {
   static const long   MJD1972     ;  // MJD at 1972
   static const double DAY2SEC     ;  // Seconds per day
   static const double SEC2DAY     ;  // Inverse seconds per day
+  static const long long NSPERDAY ;  // Nanoseconds per day
   static const long   MJDREFint   ;  // MJD at 1998.0 (integer part)
   static const double MJDREFfr    ;  // MJD at 1998.0 (fractional part)
   static const double REFLEAPS    ;  // Leap seconds at default MJDREF (1998.0 TT)
   static const double TAI2TT      ;  // TT - TAI
-  static int    NUMLEAPSECS       ;  // Number of leap seconds
-  static long   LEAPSMJD[100]     ;  // Leap second dates
-  static double LEAPSECS[100]     ;  // Leap seconds
-  static time_t WALLCLOCK0        ;  // Wallclock time when leap seconds were read
-  static int    NUMOBJECTS        ;  // Number of XTime objects instantiated
+  static std::atomic<const XTimeLeapTable*> LEAPS ;  // Leap second table in use
+  static std::atomic<time_t> WALLCLOCK0 ;  // Wallclock time of the last leap seconds file check
+  static std::atomic<int> LEAPSBUSY ;  // A leap seconds file check is in progress
+  static std::atomic<double> LEAPSINTERVAL ;  // Seconds between leap seconds file checks
+  static std::atomic<double> LEAPSREADTIME ;  // Time taken by the last file check and read (s)
+  static std::atomic<int> LEAPSLOOKUPS ;  // Number of leap seconds file checks
+  static std::atomic<int> NUMOBJECTS ;  // Number of XTime objects instantiated
 
  public:
 
@@ -117,13 +266,28 @@ class XTime {
  private:
 
   const char* monDay (const char* date, TimeFormat tf) ;
-  void setleaps (double dt=5000000.0) ;
+  void setleaps (void) ;
+  static void checkleaps (double dt) ;
+  static const XTimeLeapTable* leapTable (void) ;
+  static const XTimeLeapTable* initleaps (void) ;
+  const XTimeLeapTable* myTable (void) const ;
   int setmyleaps (double *leapval, long mjdi, double mjdf) ;
+  static int leapsAt (const XTimeLeapTable *leaps, double *leapval,
+                      long mjdi, double mjdf) ;
+  static double storedSecs (double t, double total, double mjdf) ;
+  static void ddAdd (double *hi, double *lo, double b) ;
+  static int scanLeapLine (const char *s, int *year, long *mjd, double *secs) ;
+  long dayTime (TimeSys ts, int dec, int *year, int *day,
+                int *hour, int *minute, double *second) const ;
 
 //*  Public methods
 
  public:
 
+//*    Allocation accounting (XTimeStats.h)
+
+  XTSTAT_ALLOCATOR (XTA_XTIME)
+
 //*    Constructors
 
   XTime (void) ;
@@ -134,6 +298,13 @@ class XTime {
          long mjdi=0, double mjdf=0.0) ;
   XTime (const char* date, TimeSys ts=UTC, TimeFormat tf=DATE,
          long mjdi=0, double mjdf=0.0) ;
+  XTime (const XTimeContext &ctx) ;
+  XTime (const XTimeContext &ctx, double tt, TimeSys ts=MET,
+         TimeFormat tf=SECS, long mjdi=0, double mjdf=0.0) ;
+  XTime (const XTimeContext &ctx, long tti, double ttf, TimeSys ts=TT,
+         TimeFormat tf=MJD, long mjdi=0, double mjdf=0.0) ;
+  XTime (const XTimeContext &ctx, const char* date, TimeSys ts=UTC,
+         TimeFormat tf=DATE, long mjdi=0, double mjdf=0.0) ;
 
 //*    Destructor
 
@@ -142,13 +313,30 @@ class XTime {
 //*    Set methods
 
   void setLeaps (double dt=5000000.0) ;
+  static double setLeapsInterval (double dt) ;
   void set (double tt, TimeSys ts=MET, TimeFormat tf=SECS,
             long mjdi=0, double mjdf=0.0) ;
   void set (long tti, double ttf, TimeSys ts=TT, TimeFormat tf=MJD,
             long mjdi=0, double mjdf=0.0) ;
-  void set (const char* date, TimeSys ts=UTC, TimeFormat tf=DATE,
-            long mjdi=0, double mjdf=0.0) ;
+  int set (const char* date, TimeSys ts=UTC, TimeFormat tf=DATE,
+           long mjdi=0, double mjdf=0.0) ;
   void setTZero (double tz) ;
+  void setNanos (long long ns, TimeSys ts=TT) ;
+
+//*    Leap seconds file
+
+  static int parseLeaps (const char *buf, XTimeLeapTable *leaps) ;
+  static int readLeaps (const char *file, XTimeLeapTable *leaps) ;
+
+//*    Batch conversion between UTC and TT seconds
+
+  static void makeSegments (const XTimeLeapTable *leaps, long mjdi, double mjdf,
+                            XTimeUTCSegments *seg) ;
+  static const XTimeUTCSegments* utcSegments (void) ;
+  static long convertSecs (const double *tin, double *tout, long n, int toUTC,
+                           const XTimeUTCSegments *seg=0) ;
+  static void convertNanos (const long long *tin, long long *tout, long n, int toUTC,
+                            const XTimeUTCSegments *seg=0) ;
 
 //*    Get methods
 
@@ -159,7 +347,12 @@ class XTime {
   double getTAI (void) const ;
   double getUTC (void) const ;
   double getTZero (void) const ;
+  long long getNanos (TimeSys ts=TT) const ;
+  double getHiLo (double *lo, TimeSys ts=TT, TimeFormat tf=MJD) const ;
   const char* getDate (TimeSys ts=UTC, TimeFormat tf=DATE, int dec=0) ;
+  long getFields (int *year, int *yday, int *month, int *mday,
+                  int *hour, int *minute, double *second,
+                  TimeSys ts=UTC, int dec=0) const ;
   const char* UTDate (void) ;
   const char* TTDate (void) ;
   const char* TAIDate (void) ;
@@ -180,6 +373,9 @@ class XTime {
   double TAIjd (void) const ;
   int numObjects (void) ;
   int leapSecs (const double** secs) const ;
+  int leapDates (const long** mjds) const ;
+  int leapSource (const char** file, double* readtime, int* fallback) const ;
+  int leapLookups (void) const ;
 
 } ;
 
@@ -193,11 +389,12 @@ class XTime {
 //  int    leapflag    ;               // Indicator whether we are in a leap second
 //  double myLeaps     ;               // Leap seconds at this time
 //  double refLeaps    ;               // Leap seconds at reference epoch
+//  const XTimeLeapTable *table ;      // Leap second table of the context (NULL: global)
 // Constructor: default constructor; set time to zero.
 inline XTime::XTime (void)
   : MJDint (MJDREFint), MJDfr (MJDREFfr), timeZero (0.0),
     MJDrefint (MJDREFint), MJDreffr (MJDREFfr),
-    leapflag (0), myLeaps (REFLEAPS), refLeaps (REFLEAPS)
+    leapflag (0), myLeaps (REFLEAPS), refLeaps (REFLEAPS), table (NULL)
 { setleaps() ; }
 
 // Description:
@@ -205,9 +402,16 @@ inline XTime::XTime (void)
 inline XTime::XTime (double tt)
   : MJDint (MJDREFint), MJDfr (MJDREFfr+tt*SEC2DAY), timeZero (0.0),
     MJDrefint (MJDREFint), MJDreffr (MJDREFfr),
-    leapflag (0), refLeaps (REFLEAPS)
+    leapflag (0), refLeaps (REFLEAPS), table (NULL)
 {
   setleaps() ;
+  long j = (long) MJDfr ;
+  MJDint += j ;
+  MJDfr -= j ;
+  if ( MJDfr < 0.0 ) {
+    MJDfr++ ;
+    MJDint-- ;
+  }
   leapflag = setmyleaps (&myLeaps, MJDint, MJDfr) ;
 }
 
@@ -219,7 +423,7 @@ inline XTime::XTime (double tt)
 inline XTime::XTime (double tt, TimeSys ts, TimeFormat tf,
 		     long mjdi, double mjdf)
   : timeZero (0.0), MJDrefint (MJDREFint), MJDreffr (MJDREFfr), 
-    leapflag (0), refLeaps (REFLEAPS)
+    leapflag (0), refLeaps (REFLEAPS), table (NULL)
 {
   setleaps() ;
   set (tt, ts, tf, mjdi, mjdf) ;
@@ -234,7 +438,7 @@ inline XTime::XTime (double tt, TimeSys ts, TimeFormat tf,
 inline XTime::XTime (long tti, double ttf, TimeSys ts, TimeFormat tf,
 		     long mjdi, double mjdf)
   : timeZero (0.0), MJDrefint (MJDREFint), MJDreffr (MJDREFfr),
-    leapflag (0), refLeaps (REFLEAPS) 
+    leapflag (0), refLeaps (REFLEAPS), table (NULL)
 {
   setleaps() ;
   set (tti, ttf, ts, tf, mjdi, mjdf) ;
@@ -248,7 +452,56 @@ inline XTime::XTime (long tti, double ttf, TimeSys ts, TimeFormat tf,
 // (i.e., default value); default for mjdf is 0.0.
 inline XTime::XTime (const char* date, TimeSys ts, TimeFormat tf,
 		     long mjdi, double mjdf)
-  : timeZero (0.0), MJDrefint (MJDREFint), MJDreffr (MJDREFfr), leapflag (0), refLeaps (31.0)
+  : timeZero (0.0), MJDrefint (MJDREFint), MJDreffr (MJDREFfr), leapflag (0), refLeaps (31.0),
+    table (NULL)
+{
+  setleaps() ;
+  set (date, ts, tf, mjdi, mjdf) ;
+}
+
+// Description:
+// Constructor: create in context ctx (see XTimeContext); set time to
+// zero, at the MJDref of ctx.
+inline XTime::XTime (const XTimeContext &ctx)
+  : MJDint (ctx.mjdrefi), MJDfr (ctx.mjdreff), timeZero (0.0),
+    MJDrefint (ctx.mjdrefi), MJDreffr (ctx.mjdreff),
+    leapflag (0), myLeaps (ctx.refLeaps), refLeaps (ctx.refLeaps), table (ctx.leaps)
+{ setleaps() ; }
+
+// Description:
+// Constructor: create in context ctx from seconds, MJD, or JD (tt),
+// specified by ts and tf; the default MJDref (mjdi 0) is that of
+// ctx.  Default for ts is MET, for tf SECS.
+inline XTime::XTime (const XTimeContext &ctx, double tt, TimeSys ts,
+		     TimeFormat tf, long mjdi, double mjdf)
+  : timeZero (0.0), MJDrefint (ctx.mjdrefi), MJDreffr (ctx.mjdreff),
+    leapflag (0), refLeaps (ctx.refLeaps), table (ctx.leaps)
+{
+  setleaps() ;
+  set (tt, ts, tf, mjdi, mjdf) ;
+}
+
+// Description:
+// Constructor: create in context ctx from seconds, MJD, or JD
+// (tti+ttf), specified by ts and tf; the default MJDref is that of
+// ctx.  Default for ts is TT, for tf MJD.
+inline XTime::XTime (const XTimeContext &ctx, long tti, double ttf,
+		     TimeSys ts, TimeFormat tf, long mjdi, double mjdf)
+  : timeZero (0.0), MJDrefint (ctx.mjdrefi), MJDreffr (ctx.mjdreff),
+    leapflag (0), refLeaps (ctx.refLeaps), table (ctx.leaps)
+{
+  setleaps() ;
+  set (tti, ttf, ts, tf, mjdi, mjdf) ;
+}
+
+// Description:
+// Constructor: create in context ctx from a date string (DATE,
+// CALDATE, or FITSDATE), specified by ts and tf; the default MJDref
+// is that of ctx.  Default for ts is UTC, for tf DATE.
+inline XTime::XTime (const XTimeContext &ctx, const char* date,
+		     TimeSys ts, TimeFormat tf, long mjdi, double mjdf)
+  : timeZero (0.0), MJDrefint (ctx.mjdrefi), MJDreffr (ctx.mjdreff),
+    leapflag (0), refLeaps (ctx.refLeaps), table (ctx.leaps)
 {
   setleaps() ;
   set (date, ts, tf, mjdi, mjdf) ;
@@ -257,7 +510,7 @@ inline XTime::XTime (const char* date, TimeSys ts, TimeFormat tf,
 // Description:
 // Destructor: decrement object counter
 inline XTime::~XTime (void) {
-  NUMOBJECTS-- ;
+  NUMOBJECTS.fetch_sub (1, std::memory_order_relaxed) ;
 }
 
 // Description:
@@ -270,15 +523,75 @@ inline void XTime::setTZero (double tz) {
 // Description:
 // Force refreshing leapseconds table (public method).
 // Function to set leap second table
-// If it was more than abs(dt) seconds since the
-// leap seconds were read, the leap second table
-// is refreshed; if dt > 0, only additional leap
-// seconds are added; if dt < 0, all leap seconds
-// are refreshed.  The default is dt=5000000 (about
-// two months).
+// If it was abs(dt) seconds or more since the
+// leap seconds file was checked, it is checked now
+// and read if it changed; if dt > 0, only additional
+// leap seconds are added; if dt < 0, the file is read
+// even if it did not change, and all leap seconds are
+// refreshed.  The default is dt=5000000 (about two
+// months).
 inline void XTime::setLeaps (double dt) {
-  setleaps (dt) ;
-  NUMOBJECTS-- ;
+  checkleaps (dt) ;
+}
+
+// Description:
+// Return the leap second table in use; the first call sets up the
+// built-in one.
+inline const XTimeLeapTable* XTime::leapTable (void) {
+  const XTimeLeapTable *leaps = LEAPS.load (std::memory_order_acquire) ;
+  return leaps ? leaps : initleaps () ;
+}
+
+// Description:
+// Return the leap second table of this object: that of its context,
+// or the one in use for the global context.
+inline const XTimeLeapTable* XTime::myTable (void) const {
+  return table ? table : leapTable () ;
+}
+
+// Description:
+// Set the interval (s) at which XTime objects check the leap
+// seconds file for changes (default 3600); return the previous one.
+inline double XTime::setLeapsInterval (double dt) {
+  return LEAPSINTERVAL.exchange (dt, std::memory_order_relaxed) ;
+}
+
+// Description:
+// Return the UTC offset segments of the leap second table in use,
+// for the default MJDref.
+inline const XTimeUTCSegments* XTime::utcSegments (void) {
+  return &leapTable ()->segments ;
+}
+
+// Description:
+// Return SECS time t, with total seconds added, as set stores it and
+// getMET returns it for MJDref fraction mjdf: split into days and
+// fraction the same way, so that the result is the same to the bit.
+inline double XTime::storedSecs (double t, double total, double mjdf) {
+  long tti = (long) t ;
+  double ttf = t - tti ;
+  long k = (long) ((double) tti * SEC2DAY) ;
+  double x = (double) tti * SEC2DAY - k ;
+  x += ttf * SEC2DAY + mjdf ;
+  x += total * SEC2DAY ;
+  long j = (long) x ;
+  k += j ;
+  x -= j ;
+  if ( x < 0.0 ) {
+    x++ ;
+    k-- ;
+  }
+  return (k + (x - mjdf) + 0.0) * DAY2SEC ;
+}
+
+// Description:
+// Add b to the double-double hi+lo without rounding error: hi gets
+// the rounded sum and the error of that (two-sum) is added to lo.
+inline void XTime::ddAdd (double *hi, double *lo, double b) {
+  double s = *hi + b ;
+  double bb = s - *hi ;
+  *lo += ( *hi - ( s - bb ) ) + ( b - bb ) ;
+  *hi = s ;
 }
 
 // Description:
@@ -425,15 +738,81 @@ inline double XTime::TAIjd (void) const {
 // Description:
 // Return number of existing XTime objects
 inline int XTime::numObjects (void) {
-  return NUMOBJECTS ;
+  return NUMOBJECTS.load (std::memory_order_relaxed) ;
 }
 
 // Description:
 // Return number of leapsecond entries.
 // Actual times are in array secs.
 inline int XTime::leapSecs (const double** secs) const {
-  *secs = LEAPSECS ;
-  return NUMLEAPSECS ;
+  const XTimeLeapTable *leaps = myTable () ;
+  *secs = leaps->secs.data () ;
+  return leaps->num ;
+}
+
+// Description:
+// Return number of leapsecond entries.
+// The MJDs (UTC) at which they took effect are in array mjds.
+inline int XTime::leapDates (const long** mjds) const {
+  const XTimeLeapTable *leaps = myTable () ;
+  *mjds = leaps->mjd.data () ;
+  return leaps->num ;
+}
+
+// Description:
+// Return number of leapsecond entries.
+// The file they were read from ("" if none) is in file, the time
+// taken by the last check and read of the file (s) in readtime,
+// and whether the built-in table is in use (no newer file found,
+// or none could be read) in fallback.
+inline int XTime::leapSource (const char** file, double* readtime, int* fallback) const {
+  const XTimeLeapTable *leaps = myTable () ;
+  *file = leaps->file ;
+  *readtime = LEAPSREADTIME.load (std::memory_order_relaxed) ;
+  *fallback = !leaps->file[0] ;
+  return leaps->num ;
+}
+
+// Description:
+// Return the number of times the leap seconds file was checked
+// (and read, if it changed).
+inline int XTime::leapLookups (void) const {
+  return LEAPSLOOKUPS.load (std::memory_order_relaxed) ;
+}
+
+// Description:
+// Return whether this is the global context (no table of its own).
+inline int XTimeContext::isGlobal (void) const {
+  return leaps == NULL ;
+}
+
+// Description:
+// Return the leap second table of the context: its own, or the one
+// in use for the global context.
+inline const XTimeLeapTable* XTimeContext::leapTable (void) const {
+  return leaps ? leaps : XTime::leapTable () ;
+}
+
+// Description:
+// Return the UTC offset segments of the context, for its MJDref, as
+// XTime::convertSecs takes them.
+inline const XTimeUTCSegments* XTimeContext::utcSegments (void) const {
+  return &leapTable ()->segments ;
+}
+
+// Description:
+// Return the default MJDref (TT) of the context and fill the
+// arguments with its integer and fractional parts.
+inline double XTimeContext::mjdRef (long *mjdi, double *mjdf) const {
+  *mjdi = mjdrefi ;
+  *mjdf = mjdreff ;
+  return mjdrefi + mjdreff ;
+}
+
+// Description:
+// Return the leap seconds at the default MJDref of the context.
+inline double XTimeContext::refLeapSecs (void) const {
+  return refLeaps ;
 }
 
 //
@@ -460,6 +839,10 @@ class XTimeRange {
 
  public:
 
+//*    Allocation accounting (XTimeStats.h)
+
+  XTSTAT_ALLOCATOR (XTA_XTIMERANGE)
+
 //*    Constructors
 
   XTimeRange (void) ;
@@ -655,12 +1038,17 @@ class XTRList {
 
  public:
 
+//*    Allocation accounting (XTimeStats.h)
+
+  XTSTAT_ALLOCATOR (XTA_XTRLIST)
+
 //*    Constructors
 
   XTRList (void) ;
   XTRList (const XTimeRange &T) ;
   XTRList (const XTRList &trl) ;
   XTRList (const XTRList &trl1, const XTRList &trl2) ;
+  XTRList (const double *tstart, const double *tstop, int n) ;
 
 //*    Destructor
 
@@ -690,13 +1078,20 @@ class XTRList {
   double totalTime (void) const ;
   void printList (void) ;
   void printListCal (void) ;
+
+//*    Memory diagnostics
+
+  long memoryUsed (void) const ;                 //  Bytes of list and ranges
+  int scanLength (double t) const ;              //  Ranges isInRange examines
+  long bytesTouched (double t, int line=64) const ;
 } ;
 
 // Description:
 // Default constructor for a single XTimeRange List
 inline XTRList::XTRList (void)
   : numXTRs (1), empty(1) {
-  tr = new XTimeRange () ;
+  XTSTAT_CALL (XTA_XTRLIST_NEW) ;
+  tr = new XTimeRange[1] ;
   listRange =* tr ;
 }
 
@@ -704,7 +1099,9 @@ inline XTRList::XTRList (void)
 // Constructor for a single XTimeRange List
 inline XTRList::XTRList (const XTimeRange &T)
   : listRange (T), numXTRs (1) {
-  tr = new XTimeRange (T) ;
+  XTSTAT_CALL (XTA_XTRLIST_NEW) ;
+  tr = new XTimeRange[1] ;
+  *tr = T ;
   empty = T.isEmpty () ;
 }
 
@@ -735,4 +1132,11 @@ inline int XTRList::isEmpty (void) const {
   return empty ;
 }
 
+// Description:
+// Return the bytes of memory the list occupies: the object itself and
+// its array of ranges (not counting the heap allocator's overhead).
+inline long XTRList::memoryUsed (void) const {
+  return sizeof (XTRList) + numXTRs * sizeof (XTimeRange) ;
+}
+
 #endif             // XTIME_H
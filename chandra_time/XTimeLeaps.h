@@ -0,0 +1,36 @@
+//----------------------------------------------------------------------
+//
+// File Name   : XTimeLeaps.h
+// Subsystem   : XFF
+// Description : Built-in leap second table
+//
+// .SECTION DESCRIPTION
+// Generated from tai-utc.dat by setup_leaps.py; do not edit.
+//
+// XTime starts from this table, so that programs convert times without
+// any file, and only replaces it by $TIMING_DIR/tai-utc.dat or
+// $ASC_DATA/tai-utc.dat if that file has a different number of leap
+// seconds or a different last one.
+//
+// Leap seconds: 28 entries, 1972 JAN  1 through 2017 JAN  1
+//
+//----------------------------------------------------------------------
+//
+
+#ifndef XTIMELEAPS_H
+#define XTIMELEAPS_H
+
+constexpr int    XTIME_LEAPS_BUILTIN_NUM = 28 ;
+constexpr long   XTIME_LEAPS_BUILTIN_MJD[] = {41317, 41499, 41683, 42048,
+                                            42413, 42778, 43144, 43509,
+                                            43874, 44239, 44786, 45151,
+                                            45516, 46247, 47161, 47892,
+                                            48257, 48804, 49169, 49534,
+                                            50083, 50630, 51179, 53736,
+                                            54832, 56109, 57204, 57754} ;
+constexpr double XTIME_LEAPS_BUILTIN_SECS[] = {10, 11, 12, 13, 14, 15, 16, 17,
+                                             18, 19, 20, 21, 22, 23, 24, 25,
+                                             26, 27, 28, 29, 30, 31, 32, 33,
+                                             34, 35, 36, 37} ;
+
+#endif
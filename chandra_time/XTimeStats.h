@@ -0,0 +1,291 @@
+//----------------------------------------------------------------------
+//
+// File Name   : XTimeStats.h
+// Subsystem   : XFF
+// Description : Optional counters and latency histograms for XTime
+//               and axTime3
+//
+// .SECTION DESCRIPTION
+// When compiled with XTIME_STATS defined, XTime and axTime3 count
+// the conversion paths they take (XTimeStatCounter) and record
+// log2-bucketed latencies of the more expensive operations
+// (XTimeStatHist): bucket b holds the calls that took 2^b through
+// 2^(b+1)-1 ns (bucket 0 also holds 0 ns, the last bucket everything
+// longer).  Statistics are kept per thread, so recording needs no
+// locking; xtimeStats returns those of the calling thread and
+// xtimeStatsReset clears them.
+//
+// Without XTIME_STATS the XTSTAT_ macros expand to empty statements
+// ((void) 0, so that "if ( x ) XTSTAT_COUNT (c) ;" keeps a body) and
+// XTSTAT_ALLOCATOR to nothing, xtimeStatsEnabled returns 0, and
+// xtimeStats returns NULL.
+//
+// Note that set_mjd also counts the final step of every date string
+// set, and that axTime3 and _convert_buffer call set and getDate, so
+// their counts include those of the XTime calls they make.
+//
+// XTIME_STATS also gives XTime, XTimeRange, and XTRList class
+// operators new and delete (XTSTAT_ALLOCATOR) that count the heap
+// allocations and bytes of each type per API call (XTimeAllocCall).
+// An allocation is charged to the outermost instrumented call in
+// progress (XTSTAT_CALL), e.g. the list copies made by orList to
+// orList, or to XTA_NONE outside them.  calls counts the outermost
+// calls, so allocations per call are allocs / calls.
+//
+//----------------------------------------------------------------------
+//
+
+#ifndef XTIMESTATS_H
+#define XTIMESTATS_H
+#include <string.h>
+#include <time.h>
+#include <new>
+
+enum XTimeStatCounter {
+  XTS_SET_SECS, XTS_SET_JD, XTS_SET_MJD,          // set per input format
+  XTS_SET_DATE, XTS_SET_CALDATE, XTS_SET_FITS,
+  XTS_SET_UTC,                                    // UTC input: leap table scan
+  XTS_LEAP_SECOND,                                // Times inside a leap second
+  XTS_SETMYLEAPS,                                 // Leap table lookups (non-UTC)
+  XTS_GET_SECS, XTS_GET_JD, XTS_GET_MJD,          // get per output format
+  XTS_GETDATE_DATE, XTS_GETDATE_CALDATE, XTS_GETDATE_FITS,
+  XTS_DATE_REJECTED,                              // Date strings set could not parse
+  XTS_SETLEAPS,                                   // setleaps calls
+  XTS_LEAPS_READ,                                 // tai-utc.dat (re-)reads
+  XTS_LEAPS_BUILTIN,                              // Built-in table loaded
+  XTS_AXTIME3,                                    // axTime3 calls
+  XTS_INPUT_REJECTED,                             // Inputs rejected by axTime3/_convert_buffer
+  XTS_BUFFER_CONVERTED,                           // Times converted by _convert_buffer
+  XTS_SEGMENT_FAST,                               // convertSecs: by the UTC offset segments
+  XTS_SEGMENT_SLOW,                               // convertSecs: by XTime (leap seconds)
+  XTS_NUM
+} ;
+
+enum XTimeStatHist {
+  XTH_SET_DATE,                                   // set from a date string
+  XTH_GETDATE,                                    // getDate
+  XTH_LEAPS_READ,                                 // Reading tai-utc.dat
+  XTH_AXTIME3,                                    // axTime3 call
+  XTH_BUFFER,                                     // One time in _convert_buffer
+  XTH_NUM
+} ;
+
+static const int XTH_BUCKETS = 32 ;
+
+enum XTimeAllocCall {
+  XTA_NONE,                                       // Outside the calls below
+  XTA_AXTIME3,                                    // axTime3
+  XTA_CONVERT_BUFFER,                             // _convert_buffer
+  XTA_XTRLIST_NEW,                                // XTRList constructors
+  XTA_XTRLIST_ASSIGN,                             // XTRList::operator=
+  XTA_OR_LIST, XTA_NOT_LIST,                      // XTRList methods
+  XTA_AND_RANGE, XTA_OR_RANGE,
+  XTA_NUM
+} ;
+
+enum XTimeAllocType {
+  XTA_XTIME, XTA_XTIMERANGE, XTA_XTRLIST,         // Type allocated
+  XTA_TYPES
+} ;
+
+static const char *const XTimeStatCounterName[XTS_NUM] = {
+  "set_secs", "set_jd", "set_mjd", "set_date", "set_caldate", "set_fits",
+  "set_utc", "leap_second", "setmyleaps",
+  "get_secs", "get_jd", "get_mjd",
+  "getdate_date", "getdate_caldate", "getdate_fits", "date_rejected",
+  "setleaps", "leaps_read", "leaps_builtin",
+  "axtime3", "input_rejected", "buffer_converted", "segment_fast", "segment_slow"} ;
+
+static const char *const XTimeStatHistName[XTH_NUM] = {
+  "set_date", "getdate", "leaps_read", "axtime3", "buffer"} ;
+
+static const char *const XTimeAllocCallName[XTA_NUM] = {
+  "none", "axtime3", "convert_buffer", "xtrlist_new", "xtrlist_assign",
+  "or_list", "not_list", "and_range", "or_range"} ;
+
+static const char *const XTimeAllocTypeName[XTA_TYPES] = {
+  "XTime", "XTimeRange", "XTRList"} ;
+
+//
+//   ------------
+// -- XTimeStats --
+//   ------------
+//
+
+// Description:
+// Statistics of one thread
+struct XTimeStats {
+  unsigned long long count[XTS_NUM] ;               // Counters
+  unsigned long long hist[XTH_NUM][XTH_BUCKETS] ;   // Latency histograms
+  unsigned long long calls[XTA_NUM] ;               // Outermost API calls
+  unsigned long long allocs[XTA_NUM][XTA_TYPES] ;   // Allocations per call and type
+  unsigned long long bytes[XTA_NUM][XTA_TYPES] ;    // Bytes allocated per call and type
+  unsigned long long frees[XTA_TYPES] ;             // Deallocations per type
+  int call ;                                        // Outermost call in progress
+} ;
+
+#ifdef XTIME_STATS
+
+//
+//   ------------
+// -- xtimeStats --
+//   ------------
+//
+
+// Description:
+// Return the statistics of the calling thread.
+inline XTimeStats *xtimeStats (void)
+{
+  static thread_local XTimeStats stats ;
+  return &stats ;
+}
+
+//
+//   ----------------
+// -- XTimeStatTimer --
+//   ----------------
+//
+
+// Description:
+// Records the lifetime of the object in histogram h.
+class XTimeStatTimer {
+  XTimeStatHist h ;
+  struct timespec t0 ;
+ public:
+  XTimeStatTimer (XTimeStatHist hist) : h (hist) {
+    clock_gettime (CLOCK_MONOTONIC, &t0) ; }
+  ~XTimeStatTimer (void) {
+    struct timespec t1 ;
+    clock_gettime (CLOCK_MONOTONIC, &t1) ;
+    long long ns = ( t1.tv_sec - t0.tv_sec ) * 1000000000LL + ( t1.tv_nsec - t0.tv_nsec ) ;
+    int b = 0 ;
+    while ( ( ns >>= 1 ) > 0 && ( b < XTH_BUCKETS-1 ) )
+      b++ ;
+    xtimeStats ()->hist[h][b]++ ;
+  }
+} ;
+
+//
+//   -----------------
+// -- XTimeAllocScope --
+//   -----------------
+//
+
+// Description:
+// Charges the allocations during the lifetime of the object to
+// call c, unless another call is already in progress.
+class XTimeAllocScope {
+  int outer ;
+ public:
+  XTimeAllocScope (XTimeAllocCall c) {
+    XTimeStats *stats = xtimeStats () ;
+    outer = ( stats->call == XTA_NONE ) ;
+    if ( outer ) {
+      stats->call = c ;
+      stats->calls[c]++ ;
+    }
+  }
+  ~XTimeAllocScope (void) {
+    if ( outer )
+      xtimeStats ()->call = XTA_NONE ; }
+} ;
+
+//
+//   ------------
+// -- xtimeAlloc --
+//   ------------
+//
+
+// Description:
+// Allocate size bytes for (an array of, if array) objects of type t
+// and charge them to the current call.
+inline void *xtimeAlloc (XTimeAllocType t, size_t size, int array)
+{
+  XTimeStats *stats = xtimeStats () ;
+  stats->allocs[stats->call][t]++ ;
+  stats->bytes[stats->call][t] += size ;
+  return array ? ::operator new[] (size) : ::operator new (size) ;
+}
+
+//
+//   -----------
+// -- xtimeFree --
+//   -----------
+//
+
+// Description:
+// Free memory allocated by xtimeAlloc.
+inline void xtimeFree (XTimeAllocType t, void *p, int array)
+{
+  if ( p )
+    xtimeStats ()->frees[t]++ ;
+  if ( array )
+    ::operator delete[] (p) ;
+  else
+    ::operator delete (p) ;
+}
+
+#define XTSTAT_COUNT(c)  ( xtimeStats ()->count[c]++ )
+#define XTSTAT_ADD(c, n) ( xtimeStats ()->count[c] += (n) )
+#define XTSTAT_TIME(h)   XTimeStatTimer xtstatTimer_ (h)
+#define XTSTAT_CALL(c)   XTimeAllocScope xtstatCall_ (c)
+#define XTSTAT_ALLOCATOR(t) \
+  static void *operator new (size_t size) { return xtimeAlloc (t, size, 0) ; } \
+  static void *operator new[] (size_t size) { return xtimeAlloc (t, size, 1) ; } \
+  static void operator delete (void *p) { xtimeFree (t, p, 0) ; } \
+  static void operator delete[] (void *p) { xtimeFree (t, p, 1) ; }
+
+inline int xtimeStatsEnabled (void) { return 1 ; }
+
+#else
+
+#define XTSTAT_COUNT(c)  ((void) 0)
+#define XTSTAT_ADD(c, n) ((void) 0)
+#define XTSTAT_TIME(h)   ((void) 0)
+#define XTSTAT_CALL(c)   ((void) 0)
+#define XTSTAT_ALLOCATOR(t)
+
+inline XTimeStats *xtimeStats (void) { return NULL ; }
+inline int xtimeStatsEnabled (void) { return 0 ; }
+
+#endif
+
+//
+//   -----------------
+// -- xtimeStatsReset --
+//   -----------------
+//
+
+// Description:
+// Clear the statistics of the calling thread (but not the call in
+// progress, if any).
+inline void xtimeStatsReset (void)
+{
+  XTimeStats *stats = xtimeStats () ;
+  if ( stats ) {
+    int call = stats->call ;
+    memset (stats, 0, sizeof (XTimeStats)) ;
+    stats->call = call ;
+  }
+}
+
+//
+//   -------------
+// -- xtimeAllocs --
+//   -------------
+//
+
+// Description:
+// Return the number of allocations (of all types) charged to call c
+// by the calling thread; 0 without XTIME_STATS.
+inline unsigned long long xtimeAllocs (XTimeAllocCall c)
+{
+  XTimeStats *stats = xtimeStats () ;
+  unsigned long long n = 0 ;
+  if ( stats )
+    for (int t=0; t<XTA_TYPES; t++)
+      n += stats->allocs[c][t] ;
+  return n ;
+}
+
+#endif
@@ -0,0 +1,318 @@
+//----------------------------------------------------------------------
+//
+// File Name   : XTimeTrace.h
+// Subsystem   : XFF
+// Description : Optional trace spans for XTime, axTime3, and the
+//               Python layer, written as Chrome trace-event JSON
+//
+// .SECTION DESCRIPTION
+// When compiled with XTIME_TRACE defined, XTime and axTime3 mark the
+// stages of a conversion with scoped spans (XTTRACE_SPAN): parsing
+// the input, XTime::set, get and getDate, formatting the output, and
+// the whole axTime3 or _convert_buffer call.  The Python layer adds
+// its own stages through xtimeTraceBegin and xtimeTraceEnd.
+//
+// Nothing is recorded until xtimeTraceStart is called; the spans
+// are then kept in memory until xtimeTraceStop writes them to a file
+// in the Chrome trace-event format (complete, "X", events with times
+// in us), which chrome://tracing and Perfetto display.
+//
+// To bound the overhead on large batches, the spans inside a
+// per-element scope (XTTRACE_ELEMENT: one time in _convert_buffer,
+// one axTime3 call) are only recorded for one element in sample;
+// spans outside them (whole batches) are always recorded.  At most
+// maxevents spans are kept; the rest are counted as dropped.
+//
+// Without XTIME_TRACE the XTTRACE_ macros expand to empty statements
+// ((void) 0), xtimeTraceEnabled returns 0, and the functions do
+// nothing.
+//
+//----------------------------------------------------------------------
+//
+
+#ifndef XTIMETRACE_H
+#define XTIMETRACE_H
+#include <stdio.h>
+#include <time.h>
+
+#ifdef XTIME_TRACE
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+//
+//   -----------------
+// -- XTimeTraceEvent --
+//   -----------------
+//
+
+// Description:
+// One recorded span
+struct XTimeTraceEvent {
+  const char *name ;                   // Span name (static or interned)
+  const char *cat ;                    // Category
+  double ts ;                          // Start (us since xtimeTraceStart)
+  double dur ;                         // Duration (us)
+  int tid ;                            // Thread
+} ;
+
+//
+//   ------------
+// -- XTimeTrace --
+//   ------------
+//
+
+// Description:
+// Trace state of the process
+struct XTimeTrace {
+  std::atomic<int> active ;            // Recording
+  long sample ;                        // Record one element in sample
+  long maxevents ;                     // Maximum number of events kept
+  long dropped ;                       // Events not kept
+  double t0 ;                          // Start time (us)
+  std::string file ;                   // Output file
+  std::vector<XTimeTraceEvent> events ;
+  std::set<std::string> names ;        // Interned names
+  std::mutex lock ;
+  XTimeTrace (void) : active (0), sample (1), maxevents (0), dropped (0), t0 (0.0) { }
+} ;
+
+//
+//   ------------
+// -- xtimeTrace --
+//   ------------
+//
+
+// Description:
+// Return the trace state.
+inline XTimeTrace *xtimeTrace (void)
+{
+  static XTimeTrace trace ;
+  return &trace ;
+}
+
+//
+//   ----------------
+// -- xtimeTraceNow --
+//   ----------------
+//
+
+// Description:
+// Return the monotonic clock in us.
+inline double xtimeTraceNow (void)
+{
+  struct timespec t ;
+  clock_gettime (CLOCK_MONOTONIC, &t) ;
+  return t.tv_sec * 1.0e6 + t.tv_nsec * 1.0e-3 ;
+}
+
+//
+//   ---------------------
+// -- xtimeTraceRecording --
+//   ---------------------
+//
+
+// Description:
+// Return a reference to the calling thread's flag whether its spans
+// are recorded (cleared for the elements that are not sampled).
+inline int &xtimeTraceRecording (void)
+{
+  static thread_local int recording = 1 ;
+  return recording ;
+}
+
+//
+//   -----------------
+// -- xtimeTraceBegin --
+//   -----------------
+//
+
+// Description:
+// Return the start time of a span, or -1 if it is not recorded.
+inline double xtimeTraceBegin (void)
+{
+  if ( !xtimeTrace ()->active.load (std::memory_order_relaxed) || !xtimeTraceRecording () )
+    return -1.0 ;
+  return xtimeTraceNow () ;
+}
+
+//
+//   ---------------
+// -- xtimeTraceEnd --
+//   ---------------
+//
+
+// Description:
+// Record span name (category cat) started at t0 (from
+// xtimeTraceBegin) and ending now; name and cat must remain valid
+// until xtimeTraceStop (string literals or xtimeTraceName).
+inline void xtimeTraceEnd (const char *name, const char *cat, double t0)
+{
+  static std::atomic<int> nthreads (0) ;
+  static thread_local int tid = ++nthreads ;
+  if ( t0 < 0.0 )
+    return ;
+  double t1 = xtimeTraceNow () ;
+  XTimeTrace *trace = xtimeTrace () ;
+  std::lock_guard<std::mutex> guard (trace->lock) ;
+  if ( !trace->active )
+    return ;
+  if ( (long) trace->events.size () >= trace->maxevents ) {
+    trace->dropped++ ;
+    return ;
+  }
+  XTimeTraceEvent e = {name, cat, t0 - trace->t0, t1 - t0, tid} ;
+  trace->events.push_back (e) ;
+}
+
+//
+//   ----------------
+// -- xtimeTraceName --
+//   ----------------
+//
+
+// Description:
+// Return a copy of name that stays valid for the life of the process.
+inline const char *xtimeTraceName (const char *name)
+{
+  XTimeTrace *trace = xtimeTrace () ;
+  std::lock_guard<std::mutex> guard (trace->lock) ;
+  return trace->names.insert (name).first->c_str () ;
+}
+
+//
+//   -----------------
+// -- XTimeTraceSpan --
+//   -----------------
+//
+
+// Description:
+// Records its lifetime as span name.
+class XTimeTraceSpan {
+  const char *name ;
+  const char *cat ;
+  double t0 ;
+ public:
+  XTimeTraceSpan (const char *n, const char *c) : name (n), cat (c), t0 (xtimeTraceBegin ()) { }
+  ~XTimeTraceSpan (void) { xtimeTraceEnd (name, cat, t0) ; }
+} ;
+
+//
+//   --------------------
+// -- XTimeTraceElement --
+//   --------------------
+//
+
+// Description:
+// Scope of one element of a batch: the spans in it are recorded for
+// one element in sample.
+class XTimeTraceElement {
+  int outer ;
+ public:
+  XTimeTraceElement (void) {
+    static thread_local long count = 0 ;
+    int &recording = xtimeTraceRecording () ;
+    outer = recording ;
+    if ( recording && xtimeTrace ()->active.load (std::memory_order_relaxed) )
+      recording = ( count++ % xtimeTrace ()->sample == 0 ) ;
+  }
+  ~XTimeTraceElement (void) { xtimeTraceRecording () = outer ; }
+} ;
+
+//
+//   -----------------
+// -- xtimeTraceStart --
+//   -----------------
+//
+
+// Description:
+// Start recording spans, to be written to file by xtimeTraceStop,
+// with one element in sample traced and at most maxevents spans kept.
+// Spans recorded before are discarded.  Returns 0.
+inline int xtimeTraceStart (const char *file, long sample, long maxevents)
+{
+  XTimeTrace *trace = xtimeTrace () ;
+  std::lock_guard<std::mutex> guard (trace->lock) ;
+  trace->file = file ;
+  trace->sample = ( sample > 0 ) ? sample : 1 ;
+  trace->maxevents = ( maxevents > 0 ) ? maxevents : 0 ;
+  trace->dropped = 0 ;
+  trace->events.clear () ;
+  trace->t0 = xtimeTraceNow () ;
+  trace->active = 1 ;
+  return 0 ;
+}
+
+//
+//   ----------------
+// -- xtimeTraceStop --
+//   ----------------
+//
+
+// Description:
+// Stop recording and write the spans as Chrome trace-event JSON to the
+// file given to xtimeTraceStart.  Returns the number of spans
+// written, or -1 if tracing was not started or the file could not be
+// written.  If dropped is not NULL, it is set to the number of spans
+// that were not kept.
+inline long xtimeTraceStop (long *dropped)
+{
+  XTimeTrace *trace = xtimeTrace () ;
+  std::lock_guard<std::mutex> guard (trace->lock) ;
+  if ( dropped )
+    *dropped = trace->dropped ;
+  if ( !trace->active )
+    return -1 ;
+  trace->active = 0 ;
+
+  FILE *FF = fopen (trace->file.c_str (), "w") ;
+  if ( FF == NULL )
+    return -1 ;
+  int pid = (int) getpid () ;
+  fprintf (FF, "{\"displayTimeUnit\": \"ns\",\n \"otherData\": {\"sample\": %ld, \"dropped\": %ld},\n"
+	   " \"traceEvents\": [", trace->sample, trace->dropped) ;
+  long n = trace->events.size () ;
+  for (long i=0; i<n; i++) {
+    const XTimeTraceEvent &e = trace->events[i] ;
+    fprintf (FF, "%s\n  {\"name\": \"", i ? "," : "") ;
+    for (const char *c=e.name; *c; c++)
+      fprintf (FF, ( *c == '"' || *c == '\\' ) ? "\\%c" : "%c", *c) ;
+    fprintf (FF, "\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %d}",
+	     e.cat, e.ts, e.dur, pid, e.tid) ;
+  }
+  fprintf (FF, "\n]}\n") ;
+  trace->events.clear () ;
+  trace->events.shrink_to_fit () ;
+  if ( fclose (FF) )
+    return -1 ;
+  return n ;
+}
+
+#define XTTRACE_CAT2_(a, b)  a ## b
+#define XTTRACE_CAT_(a, b)   XTTRACE_CAT2_ (a, b)
+#define XTTRACE_SPAN(name, cat) XTimeTraceSpan XTTRACE_CAT_ (xttraceSpan_, __LINE__) (name, cat)
+#define XTTRACE_ELEMENT()       XTimeTraceElement xttraceElement_
+
+inline int xtimeTraceEnabled (void) { return 1 ; }
+
+#else
+
+#define XTTRACE_SPAN(name, cat) ((void) 0)
+#define XTTRACE_ELEMENT()       ((void) 0)
+
+inline int xtimeTraceEnabled (void) { return 0 ; }
+inline double xtimeTraceBegin (void) { return -1.0 ; }
+inline void xtimeTraceEnd (const char *, const char *, double) { }
+inline const char *xtimeTraceName (const char *name) { return name ; }
+inline int xtimeTraceStart (const char *, long, long) { return -1 ; }
+inline long xtimeTraceStop (long *dropped) {
+  if ( dropped )
+    *dropped = 0 ;
+  return -1 ; }
+
+#endif
+
+#endif
@@ -1,7 +1,10 @@
 # distutils: language = c++
 # distutils: sources = chandra_time/axTime3.cc chandra_time/XTime.cc
 
+import os
+
 from six import PY3
+import numpy as np
 
 cdef extern from "axTime3.h":
     void *_convert_time(char *time_in,
@@ -10,6 +13,122 @@ cdef extern from "axTime3.h":
                         char *ts_out,
                         char *tf_out,
                         char *time_out,)
+    int _convert_array(const double *time_in,
+                       double *time_out,
+                       long n,
+                       char *ts_in,
+                       char *tf_in,
+                       char *ts_out,
+                       char *tf_out)
+    int _convert_buffer(const double *num_in,
+                        const void *str_in,
+                        int in_width,
+                        int in_charsize,
+                        long n,
+                        char *ts_in,
+                        char *tf_in,
+                        char *ts_out,
+                        char *tf_out,
+                        double *num_out,
+                        void *str_out,
+                        int out_width,
+                        int out_charsize,
+                        unsigned char *valid)
+    int _convert_buffer_context(const double *num_in,
+                                const void *str_in,
+                                int in_width,
+                                int in_charsize,
+                                long n,
+                                char *ts_in,
+                                char *tf_in,
+                                char *ts_out,
+                                char *tf_out,
+                                double *num_out,
+                                void *str_out,
+                                int out_width,
+                                int out_charsize,
+                                unsigned char *valid,
+                                const void *context)
+    int _convert_nanos(const long long *nanos_in,
+                       long long *nanos_out,
+                       long n,
+                       char *ts_in,
+                       char *ts_out,
+                       const void *context)
+    int _convert_hilo(const double *hi_in,
+                      const double *lo_in,
+                      long n,
+                      char *ts_in,
+                      char *tf_in,
+                      char *ts_out,
+                      char *tf_out,
+                      double *hi_out,
+                      double *lo_out,
+                      const void *context)
+    void *_context_read(const char *file,
+                        long mjdrefi,
+                        double mjdreff,
+                        int *num)
+    void *_context_table(const long *mjd,
+                         const double *secs,
+                         int n,
+                         long mjdrefi,
+                         double mjdreff)
+    void _context_free(void *context)
+    int _context_leaps(const void *context,
+                       const long **mjd,
+                       const double **secs,
+                       const char **file)
+    void _time_fields(const double *secs,
+                      long n,
+                      int dec,
+                      int *year,
+                      int *yday,
+                      int *month,
+                      int *mday,
+                      int *hour,
+                      int *minute,
+                      double *second,
+                      int *wday)
+    void _day_start(const double *secs,
+                    double *secs_out,
+                    long n,
+                    int ndays)
+    int _leap_info(const char **file,
+                   double *readtime,
+                   int *fallback,
+                   int *lookups)
+    int _leap_refresh(int force)
+    double _leap_interval(double interval)
+
+cdef extern from "XTimeStats.h":
+    enum:
+        XTS_NUM
+        XTH_NUM
+        XTH_BUCKETS
+        XTA_NUM
+        XTA_TYPES
+    ctypedef struct XTimeStats:
+        unsigned long long count[XTS_NUM]
+        unsigned long long hist[XTH_NUM][XTH_BUCKETS]
+        unsigned long long calls[XTA_NUM]
+        unsigned long long allocs[XTA_NUM][XTA_TYPES]
+        unsigned long long bytes[XTA_NUM][XTA_TYPES]
+        unsigned long long frees[XTA_TYPES]
+    const char *XTimeStatCounterName[]
+    const char *XTimeStatHistName[]
+    const char *XTimeAllocCallName[]
+    const char *XTimeAllocTypeName[]
+    XTimeStats *xtimeStats()
+    void xtimeStatsReset()
+
+cdef extern from "XTimeTrace.h":
+    int xtimeTraceEnabled()
+    double xtimeTraceBegin()
+    void xtimeTraceEnd(const char *name, const char *cat, double t0)
+    const char *xtimeTraceName(const char *name)
+    int xtimeTraceStart(const char *file, long sample, long maxevents)
+    long xtimeTraceStop(long *dropped)
 
 def convert_time(time_in, ts_in, tf_in, ts_out, tf_out):
     time_out = " " * 80
@@ -25,3 +144,427 @@ def convert_time(time_in, ts_in, tf_in, ts_out, tf_out):
         time_out = time_out.decode('ascii')
     length = time_out.index('\x00')
     return time_out[:length]
+
+cdef class TimeContext:
+    """
+    Leap second table and default MJDref for conversions, independent of the
+    global table that is kept current from the leap seconds file.
+
+    The table is read from leap seconds file ``filename`` (in the format of
+    tai-utc.dat), or given as arrays ``mjd`` (UTC MJD of each leap second)
+    and ``tai_utc`` (TAI-UTC from that date), or else is a copy of the global
+    table in use.  It is never refreshed.  ``mjdref`` is the MJD (TT) that
+    seconds count from (default 50814.0, 1998.0 TT).  The lookup structures
+    are built once, here; a context can be passed to ``convert_array`` and
+    ``convert_buffer`` from any number of threads.
+    """
+    cdef void *ctx
+    cdef readonly double mjdref
+
+    def __cinit__(self, filename=None, mjd=None, tai_utc=None, mjdref=None):
+        cdef const long[::1] mjd_view
+        cdef const double[::1] secs_view
+        cdef int num = 0
+        cdef long mjdrefi = 0
+        cdef double mjdreff = 0.0
+        if mjdref is not None:
+            mjdrefi = <long>np.floor(mjdref)
+            mjdreff = mjdref - mjdrefi
+            if mjdrefi <= 1:
+                raise ValueError('mjdref must be greater than 1')
+        self.mjdref = mjdrefi + mjdreff if mjdref is not None else 50814.0
+        if filename is not None:
+            self.ctx = _context_read(os.fsencode(filename), mjdrefi, mjdreff, &num)
+            if self.ctx == NULL:
+                raise ValueError('Cannot use leap seconds file {}: {}'.format(
+                    filename, 'cannot read it' if num == 0 else 'bad line {}'.format(-num)))
+        elif mjd is not None:
+            mjd_arr = np.ascontiguousarray(mjd, dtype=np.dtype('l'))
+            secs_arr = np.ascontiguousarray(tai_utc, dtype=np.float64)
+            if mjd_arr.ndim != 1 or secs_arr.shape != mjd_arr.shape or mjd_arr.size == 0:
+                raise ValueError('mjd and tai_utc must be non-empty 1-d arrays of one length')
+            mjd_view = mjd_arr
+            secs_view = secs_arr
+            self.ctx = _context_table(&mjd_view[0], &secs_view[0], mjd_arr.size,
+                                      mjdrefi, mjdreff)
+            if self.ctx == NULL:
+                raise ValueError('Leap second dates must increase and TAI-UTC '
+                                 'must not decrease')
+        else:
+            self.ctx = _context_table(NULL, NULL, 0, mjdrefi, mjdreff)
+
+    def __dealloc__(self):
+        if self.ctx != NULL:
+            _context_free(self.ctx)
+
+    @property
+    def leaps(self):
+        """Leap second table as arrays ``(mjd, tai_utc)``."""
+        cdef const long *mjd
+        cdef const double *secs
+        cdef const char *file
+        n = _context_leaps(self.ctx, &mjd, &secs, &file)
+        return (np.array([mjd[i] for i in range(n)], dtype=np.dtype('l')),
+                np.array([secs[i] for i in range(n)], dtype=np.float64))
+
+    @property
+    def file(self):
+        """Leap seconds file the table was read from ('' if built in or given)."""
+        cdef const long *mjd
+        cdef const double *secs
+        cdef const char *file
+        _context_leaps(self.ctx, &mjd, &secs, &file)
+        return file.decode('utf-8', 'replace')
+
+cdef const void *_context_ptr(context):
+    """Return the native time context of TimeContext ``context`` (NULL if None)."""
+    if context is None:
+        return NULL
+    return (<TimeContext?>context).ctx
+
+def convert_array(time_in, ts_in, tf_in, ts_out, tf_out, context=None):
+    """
+    Convert an array of numeric times (secs, jd or mjd) in one native call.
+
+    The system and format codes are those of ``convert_time``.  Returns a
+    float64 array with the shape of ``time_in``.  The conversion uses the
+    leap seconds and MJDref of ``context`` (a ``TimeContext``) if given.
+    """
+    vals = np.asarray(time_in, dtype=np.float64, order='C')
+    out = np.empty_like(vals)
+    cdef const double[::1] vals_view = vals.reshape(-1)
+    cdef double[::1] out_view = out.reshape(-1)
+    codes = [code.encode('ascii') for code in (ts_in, tf_in, ts_out, tf_out)]
+    cdef const void *ctx = _context_ptr(context)
+    if vals.size == 0:
+        return out
+    status = _convert_buffer_context(&vals_view[0], NULL, 0, 0, vals.size,
+                                     codes[0], codes[1], codes[2], codes[3],
+                                     &out_view[0], NULL, 0, 0, NULL, ctx)
+    if status:
+        raise ValueError('Invalid {} time system or format'
+                         .format('input' if status == 1 else 'output'))
+    return out
+
+def convert_nanos(nanos_in, ts_in, ts_out, context=None):
+    """
+    Convert integer nanoseconds since MJDref between time systems in one
+    native call, in integer arithmetic only (exact).
+
+    The system codes are those of ``convert_time``; MET, TT and TAI
+    nanoseconds are the same.  Returns an int64 array with the shape of
+    ``nanos_in``.  The conversion uses the leap seconds and MJDref of
+    ``context`` (a ``TimeContext``) if given.
+    """
+    vals = np.ascontiguousarray(nanos_in, dtype=np.longlong)
+    out = np.empty_like(vals)
+    cdef const long long[::1] vals_view = vals.reshape(-1)
+    cdef long long[::1] out_view = out.reshape(-1)
+    cdef const void *ctx = _context_ptr(context)
+    codes = [code.encode('ascii') for code in (ts_in, ts_out)]
+    if vals.size == 0:
+        return out
+    status = _convert_nanos(&vals_view[0], &out_view[0], vals.size, codes[0], codes[1], ctx)
+    if status:
+        raise ValueError('Invalid {} time system'.format('input' if status == 1 else 'output'))
+    return out
+
+def convert_hilo(hi_in, ts_in, tf_in, ts_out, tf_out, lo_in=None, context=None):
+    """
+    Convert numeric times (secs, jd or mjd) as double-doubles ``hi + lo``
+    in one native call, keeping full precision.
+
+    A JD or MJD as a single float64 is good to only about 20 us near the
+    present epoch; ``hi + lo`` keeps the precision of the time.  The
+    optional ``lo_in`` is the low part of the input (broadcast against
+    ``hi_in``).  The system and format codes are those of
+    ``convert_time``.  Returns a tuple of float64 arrays ``(hi, lo)``,
+    with ``hi`` the nearest float64 to the time.  The conversion uses the
+    leap seconds and MJDref of ``context`` (a ``TimeContext``) if given.
+    """
+    hi_vals = np.asarray(hi_in, dtype=np.float64)
+    if lo_in is not None:
+        hi_vals, lo_vals = np.broadcast_arrays(hi_vals, np.asarray(lo_in, dtype=np.float64))
+        lo_vals = np.asarray(lo_vals, order='C')
+    hi_vals = np.asarray(hi_vals, order='C')
+    hi_out = np.empty_like(hi_vals)
+    lo_out = np.empty_like(hi_vals)
+    cdef const double[::1] hi_view = hi_vals.reshape(-1)
+    cdef const double[::1] lo_view
+    cdef double[::1] hi_out_view = hi_out.reshape(-1)
+    cdef double[::1] lo_out_view = lo_out.reshape(-1)
+    cdef const double *lo_ptr = NULL
+    cdef const void *ctx = _context_ptr(context)
+    codes = [code.encode('ascii') for code in (ts_in, tf_in, ts_out, tf_out)]
+    if hi_vals.size == 0:
+        return hi_out, lo_out
+    if lo_in is not None:
+        lo_view = lo_vals.reshape(-1)
+        lo_ptr = &lo_view[0]
+    status = _convert_hilo(&hi_view[0], lo_ptr, hi_vals.size,
+                           codes[0], codes[1], codes[2], codes[3],
+                           &hi_out_view[0], &lo_out_view[0], ctx)
+    if status:
+        raise ValueError('Invalid {} time system or format'
+                         .format('input' if status == 1 else 'output'))
+    return hi_out, lo_out
+
+def _char_buffer(vals):
+    """
+    Return a flat uint8 view of the data of string array ``vals`` (kind 'S' or
+    'U'), together with the record width in characters and the bytes per
+    character.  No copy is made for contiguous native-order arrays.
+    """
+    if not vals.dtype.isnative:
+        vals = vals.astype(vals.dtype.newbyteorder('='))
+    charsize = 1 if vals.dtype.kind == 'S' else 4
+    width = vals.dtype.itemsize // charsize
+    return vals.reshape(-1).view(np.uint8), width, charsize
+
+def convert_buffer(vals, ts_in, tf_in, ts_out, tf_out, dtype_out, validate=False,
+                   context=None):
+    """
+    Convert an array of times in one native call, reading and writing the
+    array buffers in place.
+
+    The input ``vals`` can be a numeric array or a string array (numpy ``S``
+    or ``U``); string records are read directly from the array buffer without
+    creating Python strings.  The output array has the shape of ``vals`` and
+    type ``dtype_out``, which is float64 for numeric output formats or a fixed
+    width ``S`` or ``U`` string type.  The system and format codes are those
+    of ``convert_time``.
+
+    With ``validate=True`` every input is checked natively (finite number, or
+    string with the syntax of the input format) and ``(out, valid)`` is
+    returned, where ``valid`` is a boolean array with the shape of ``vals``;
+    invalid inputs are not converted and give NaN or an empty string.
+
+    The conversion uses the leap seconds and MJDref of ``context`` (a
+    ``TimeContext``) if given, else the global ones.
+    """
+    cdef double t0 = xtimeTraceBegin()
+    cdef const void *ctx = _context_ptr(context)
+    vals = np.asarray(vals, order='C')
+    if vals.dtype.kind not in 'SU':
+        vals = np.asarray(vals, dtype=np.float64, order='C')
+    out = np.empty(vals.shape, dtype=dtype_out)
+    valid = np.ones(vals.shape, dtype=np.bool_) if validate else None
+    if vals.size == 0:
+        return (out, valid) if validate else out
+
+    cdef const double[::1] num_in
+    cdef const unsigned char[::1] str_in
+    cdef double[::1] num_out
+    cdef unsigned char[::1] str_out
+    cdef const double *num_in_ptr = NULL
+    cdef const void *str_in_ptr = NULL
+    cdef double *num_out_ptr = NULL
+    cdef void *str_out_ptr = NULL
+    cdef unsigned char[::1] valid_view
+    cdef unsigned char *valid_ptr = NULL
+    cdef int in_width = 0, in_charsize = 0, out_width = 0, out_charsize = 0
+
+    if vals.dtype.kind in 'SU':
+        buf, in_width, in_charsize = _char_buffer(vals)
+        str_in = buf
+        str_in_ptr = &str_in[0]
+    else:
+        num_in = vals.reshape(-1)
+        num_in_ptr = &num_in[0]
+
+    if out.dtype.kind in 'SU':
+        buf, out_width, out_charsize = _char_buffer(out)
+        str_out = buf
+        str_out_ptr = &str_out[0]
+    else:
+        num_out = out.reshape(-1)
+        num_out_ptr = &num_out[0]
+
+    if validate:
+        valid_view = valid.reshape(-1).view(np.uint8)
+        valid_ptr = &valid_view[0]
+
+    codes = [code.encode('ascii') for code in (ts_in, tf_in, ts_out, tf_out)]
+    xtimeTraceEnd(b'convert_buffer.prepare', b'python', t0)
+    status = _convert_buffer_context(num_in_ptr, str_in_ptr, in_width, in_charsize,
+                                     vals.size, codes[0], codes[1], codes[2], codes[3],
+                                     num_out_ptr, str_out_ptr, out_width, out_charsize,
+                                     valid_ptr, ctx)
+    if status:
+        raise ValueError('Invalid {} time system or format'
+                         .format('input' if status == 1 else 'output'))
+    return (out, valid) if validate else out
+
+def time_fields(secs, dec=3):
+    """
+    Decompose CXC seconds into UTC calendar fields in one native call.
+
+    Returns a dict of arrays with the shape of ``secs``: ``year``, ``yday``,
+    ``mon``, ``day``, ``hour``, ``min`` and ``wday`` (0 is Monday) as C int,
+    and ``sec`` as float64 rounded to ``dec`` decimals like the date string.
+    """
+    vals = np.asarray(secs, dtype=np.float64, order='C')
+    names = ('year', 'yday', 'mon', 'day', 'hour', 'min', 'wday')
+    fields = {name: np.empty(vals.shape, dtype=np.intc) for name in names}
+    fields['sec'] = np.empty(vals.shape, dtype=np.float64)
+    if vals.size == 0:
+        return fields
+
+    cdef const double[::1] vals_view = vals.reshape(-1)
+    cdef int[::1] year = fields['year'].reshape(-1)
+    cdef int[::1] yday = fields['yday'].reshape(-1)
+    cdef int[::1] mon = fields['mon'].reshape(-1)
+    cdef int[::1] day = fields['day'].reshape(-1)
+    cdef int[::1] hour = fields['hour'].reshape(-1)
+    cdef int[::1] minute = fields['min'].reshape(-1)
+    cdef double[::1] sec = fields['sec'].reshape(-1)
+    cdef int[::1] wday = fields['wday'].reshape(-1)
+    _time_fields(&vals_view[0], vals.size, dec, &year[0], &yday[0], &mon[0], &day[0],
+                 &hour[0], &minute[0], &sec[0], &wday[0])
+    return fields
+
+def day_start(secs, ndays=0):
+    """
+    Return CXC seconds of the start of the UTC day of ``secs``, plus ``ndays``
+    days, as a float64 array with the shape of ``secs``.
+    """
+    vals = np.asarray(secs, dtype=np.float64, order='C')
+    out = np.empty_like(vals)
+    if vals.size == 0:
+        return out
+
+    cdef const double[::1] vals_view = vals.reshape(-1)
+    cdef double[::1] out_view = out.reshape(-1)
+    _day_start(&vals_view[0], &out_view[0], vals.size, ndays)
+    return out
+
+def leap_info():
+    """
+    Return a dict describing the leap second table: ``file`` that it was read
+    from ('' if none), ``read_time`` of the last lookup and read of the file
+    (seconds), number of ``entries``, ``fallback`` (True if the built-in table
+    is in use) and the number of file ``lookups``.
+    """
+    cdef const char *file
+    cdef double readtime
+    cdef int fallback, lookups
+    entries = _leap_info(&file, &readtime, &fallback, &lookups)
+    return {'file': file.decode('utf-8', 'replace'), 'read_time': readtime,
+            'entries': entries, 'fallback': bool(fallback), 'lookups': lookups}
+
+def leap_refresh(force=False):
+    """
+    Check the leap seconds file now and read it if it changed (or if
+    ``force``); return the number of entries in the table.
+    """
+    return _leap_refresh(1 if force else 0)
+
+def leap_interval(interval=-1.0):
+    """
+    Set the interval (seconds) at which the leap seconds file is checked for
+    changes, unless ``interval`` is negative; return the previous interval.
+    """
+    return _leap_interval(interval)
+
+def stats():
+    """
+    Return the conversion statistics of the calling thread, or None if the
+    extension was built without them (see XTimeStats.h).
+
+    The result is a dict with ``counters``, a dict of counts per conversion
+    path, ``histograms``, a dict of uint64 arrays of latencies where
+    element ``b`` counts the calls that took 2**b to 2**(b+1)-1 ns, and
+    ``allocations``, a dict per API call (e.g. ``axtime3``, ``or_range``,
+    ``none`` for allocations outside them) of dicts with the number of
+    ``calls`` and per allocated type (``XTime``, ``XTimeRange``, ``XTRList``)
+    the number of ``allocs`` and ``bytes``, plus ``frees`` per type.
+    """
+    cdef XTimeStats *st = xtimeStats()
+    if st == NULL:
+        return None
+    counters = {XTimeStatCounterName[i].decode('ascii'): st.count[i]
+                for i in range(XTS_NUM)}
+    histograms = {XTimeStatHistName[h].decode('ascii'):
+                  np.array([st.hist[h][b] for b in range(XTH_BUCKETS)], dtype=np.uint64)
+                  for h in range(XTH_NUM)}
+    types = [XTimeAllocTypeName[t].decode('ascii') for t in range(XTA_TYPES)]
+    allocations = {XTimeAllocCallName[c].decode('ascii'):
+                   {'calls': st.calls[c],
+                    'allocs': {types[t]: st.allocs[c][t] for t in range(XTA_TYPES)},
+                    'bytes': {types[t]: st.bytes[c][t] for t in range(XTA_TYPES)}}
+                   for c in range(XTA_NUM)}
+    allocations['frees'] = {types[t]: st.frees[t] for t in range(XTA_TYPES)}
+    return {'counters': counters, 'histograms': histograms, 'allocations': allocations}
+
+def reset_stats():
+    """Clear the conversion statistics of the calling thread."""
+    xtimeStatsReset()
+
+_trace_active = False
+_trace_names = {}
+
+cdef class TraceSpan:
+    """
+    Context manager that records its duration as a trace span (see
+    ``trace_start``).  Made by ``trace_span``.
+    """
+    cdef const char *name
+    cdef double t0
+
+    def __enter__(self):
+        if self.name != NULL:
+            self.t0 = xtimeTraceBegin()
+        return self
+
+    def __exit__(self, *exc):
+        if self.name != NULL:
+            xtimeTraceEnd(self.name, b'python', self.t0)
+        return False
+
+_no_span = TraceSpan()
+
+def trace_span(name):
+    """
+    Return a context manager that records the time spent in it as trace span
+    ``name`` while tracing, and does nothing otherwise.
+    """
+    if not _trace_active:
+        return _no_span
+    cdef TraceSpan span = TraceSpan()
+    ptr = _trace_names.get(name)
+    if ptr is None:
+        ptr = _trace_names[name] = <size_t> xtimeTraceName(name.encode('utf-8'))
+    span.name = <const char *> <size_t> ptr
+    return span
+
+def trace_start(filename, sample=1000, max_events=1000000):
+    """
+    Start recording trace spans of the conversion stages, to be written to
+    ``filename`` as Chrome trace-event JSON by ``trace_stop``.  The spans
+    within each time of a batch (or each single conversion) are recorded for
+    one time in ``sample``, and at most ``max_events`` spans are kept.
+    Returns False if the extension was built without tracing (see
+    XTimeTrace.h).
+    """
+    global _trace_active
+    if not xtimeTraceEnabled():
+        return False
+    xtimeTraceStart(os.fsencode(filename), sample, max_events)
+    _trace_active = True
+    return True
+
+def trace_stop():
+    """
+    Stop tracing and write the trace file.  Returns a dict with the number
+    of ``events`` written and ``dropped``, or None if tracing was not
+    started.  Raises OSError if the file could not be written.
+    """
+    global _trace_active
+    cdef long dropped
+    if not _trace_active:
+        return None
+    _trace_active = False
+    events = xtimeTraceStop(&dropped)
+    if events < 0:
+        raise OSError('Could not write the trace file')
+    return {'events': events, 'dropped': dropped}
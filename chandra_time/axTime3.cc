@@ -57,19 +57,28 @@ static const char* const rcsid = "axTime $Id: axTime3.cc,v 1.2 2007-08-27 21:30:
 
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 #include <stdlib.h>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <limits.h>
+#include <math.h>
 #include "XTime.h"
+#include "XTimeStats.h"
+#include "XTimeTrace.h"
 using namespace std;
 
 XTime *getinput (int, char **) ;
+int setinput (XTime *, const char *, XTime::TimeSys, XTime::TimeFormat, int, int) ;
+void putoutput (XTime *, XTime::TimeSys, XTime::TimeFormat, int, int, int, char *) ;
 int getsys (XTime::TimeSys *) ;
 int readsys (char *, XTime::TimeSys *) ;
 int getform (XTime::TimeFormat *, int *, int *, int *) ;
 int readform (char *, XTime::TimeFormat *, int *, int *, int *) ;
+int _convert_buffer_context (const double *, const void *, int, int, long, char *, char *,
+			     char *, char *, double *, void *, int, int, unsigned char *,
+			     const void *) ;
 
 //
 //   -------
@@ -102,6 +111,12 @@ void axTime3 (char *time_in,
   int argc = 6;
   char *argv[6];
   
+  XTSTAT_COUNT (XTS_AXTIME3) ;
+  XTSTAT_TIME (XTH_AXTIME3) ;
+  XTSTAT_CALL (XTA_AXTIME3) ;
+  XTTRACE_ELEMENT () ;
+  XTTRACE_SPAN ("axTime3", "axTime3") ;
+
 //  Errr, I don't know c anymore..  
   argv[0] = "convert_time";
   argv[1] = time_in;
@@ -111,8 +126,13 @@ void axTime3 (char *time_in,
   argv[5] = tf_out;
 
 //    Get the time
-  if ( ( T = getinput(argc, argv) ) == NULL ) {
+  {
+    XTTRACE_SPAN ("getinput", "axTime3") ;
+    T = getinput(argc, argv) ;
+  }
+  if ( T == NULL ) {
     sprintf(time_out, "Error: Incorrect time format; try again");
+    XTSTAT_COUNT (XTS_INPUT_REJECTED) ;
     error = 1 ;
   }
 
@@ -132,38 +152,8 @@ void axTime3 (char *time_in,
     }
 
 //      Convert and print the result
-    if ( !error ) {
-      switch (tForm) {
-      case XTime::SECS : case XTime::JD : case XTime::MJD : {
-	double t = T->get(tSys, tForm) ;
-	if ( hexfmt ) {
-	  unsigned int jt = (unsigned long) t ;
-	  sprintf(time_out, "0x%7x", jt);
-	  //	  cout << "0x" << setw(7) << hex << jt ;
-	}
-	else if ( nmday ) {
-	  int day = (int) t / 86400 ;
-	  t -= day * 86400 ;
-	  int h = (int) t / 3600 ;
-	  t -= h * 3600 ;
-	  int m = (int) t / 60 ;
-	  t -= m * 60 ;
-	  sprintf(time_out, "%d:%d:%d:%.10f", day, h, m, t);
-	  //	  cout << dec << day << ":" << h << ":" << m << ":"
-	  //	       << setprecision(10) << t ;
-	}
-	else 
-	  //	  cout << setprecision(18) << t ;
-	  sprintf(time_out, "%.9f", t);
-	break ;
-      }
-      case XTime::DATE : case XTime::CALDATE : case XTime::FITS : {
-	const char *s = T->getDate(tSys, tForm, dec) ;
-	sprintf(time_out, "%s", s);
-	break ;
-      }
-      }
-    }
+    if ( !error )
+      putoutput (T, tSys, tForm, hexfmt, nmday, dec, time_out) ;
     delete(T);
   }
 
@@ -180,6 +170,807 @@ void _convert_time(char *time_in,
   axTime3(time_in, ts_in, tf_in, ts_out, tf_out, time_out);
 }
 
+//
+//   --------
+// -- round9 --
+//   --------
+//
+
+// Description:
+// Round t to 9 decimals, as printed by axTime3 ("%.9f"), so that
+// numeric results match those of the string interface.  From 2^23
+// on, the spacing of doubles exceeds 1e-9 / 2 and t is returned
+// unchanged.  Below, t * 1e9 rounds to the integer n exactly as
+// printf rounds t; only when the product looks like a tie is its
+// rounding error (fma) needed to tell.  n / 1e9 is then the double
+// nearest to the printed value, as atof would return.
+static double round9 (double t)
+{
+  if ( fabs (t) >= 8388608.0 )
+    return t ;
+  double p = t * 1.0e9 ;
+  double n = nearbyint (p) ;
+  if ( fabs (p - n) == 0.5 ) {
+    double e = fma (t, 1.0e9, -p) ;
+    if ( ( p - n == 0.5 ) && ( e > 0.0 ) )
+      n += 1.0 ;
+    else if ( ( p - n == -0.5 ) && ( e < 0.0 ) )
+      n -= 1.0 ;
+  }
+  return n / 1.0e9 ;
+}
+
+//
+//   -----------
+// -- getrecord --
+//   -----------
+//
+
+// Description:
+// Copy record i of a buffer of fixed-width strings of width characters
+// of charsize (1 or 4) bytes into str (of size bytes), NUL-terminated.
+// A record ends at its first NUL character or after width characters.
+// Return 1 if the record has a non-ASCII character or does not fit.
+static int getrecord (const void *buf, long i, int width, int charsize,
+                      char *str, int size)
+{
+  int j ;
+
+  if ( charsize == 1 ) {
+    const unsigned char *rec = (const unsigned char *) buf + i * width ;
+    for (j=0; ( j < width ) && rec[j]; j++) {
+      if ( ( j >= size-1 ) || ( rec[j] > 127 ) )
+	return 1 ;
+      str[j] = rec[j] ;
+    }
+  }
+  else {
+    const unsigned int *rec = (const unsigned int *) buf + i * width ;
+    for (j=0; ( j < width ) && rec[j]; j++) {
+      if ( ( j >= size-1 ) || ( rec[j] > 127 ) )
+	return 1 ;
+      str[j] = rec[j] ;
+    }
+  }
+  str[j] = 0 ;
+  return 0 ;
+}
+
+//
+//   -----------
+// -- putrecord --
+//   -----------
+//
+
+// Description:
+// Copy str into record i of a buffer of fixed-width strings of width
+// characters of charsize (1 or 4) bytes; truncate or pad with NULs.
+static void putrecord (void *buf, long i, int width, int charsize,
+                       const char *str)
+{
+  int j ;
+
+  if ( charsize == 1 ) {
+    char *rec = (char *) buf + i * width ;
+    strncpy (rec, str, width) ;
+  }
+  else {
+    unsigned int *rec = (unsigned int *) buf + i * width ;
+    for (j=0; ( j < width ) && str[j]; j++)
+      rec[j] = (unsigned char) str[j] ;
+    for (; j<width; j++)
+      rec[j] = 0 ;
+  }
+  return ;
+}
+
+//
+//   ------------
+// -- scandigits --
+//   ------------
+//
+
+// Description:
+// Skip between nmin and nmax decimal digits at the start of str.
+// Return a pointer past the digits, or NULL if there are too few.
+static const char *scandigits (const char *str, int nmin, int nmax)
+{
+  int n = 0 ;
+
+  while ( ( n < nmax ) && isdigit ((unsigned char) str[n]) )
+    n++ ;
+  return ( n < nmin ) ? NULL : str + n ;
+}
+
+//
+//   ------------
+// -- scanfields --
+//   ------------
+//
+
+// Description:
+// Skip nfield integer fields of nmin to nmax digits each, separated by
+// sep, followed by an optional fraction (".ddd"); this is the end of
+// DATE, FITS, CALDATE, and NUMDAY strings.  Return 1 if that is all
+// there is in str.
+static int scanfields (const char *str, int nfield, int nmin, int nmax, char sep)
+{
+  int i ;
+
+  for (i=0; i<nfield; i++) {
+    if ( i && ( *str++ != sep ) )
+      return 0 ;
+    if ( ( str = scandigits (str, nmin, nmax) ) == NULL )
+      return 0 ;
+  }
+  if ( *str == '.' )
+    str = scandigits (str+1, 0, INT_MAX) ;
+  return !*str ;
+}
+
+//
+//   ------------
+// -- checkinput --
+//   ------------
+//
+
+// Description:
+// Check that str is a well-formed time in format tForm (hexfmt and
+// nmday as returned by readform), following the syntax that the
+// DateTime class accepts for that format:
+//   DATE     yyyy:ddd:hh:mm:ss[.sss]
+//   FITS     yyyy-m[m]-d[d]Th[h]:m[m]:s[s][.sss]
+//   CALDATE  yyyyMond[d] at h[h]:m[m]:s[s][.sss]
+//   NUMDAY   d[ddd]:h[h]:m[m]:s[s][.sss]
+//   numbers  [+-]digits[.digits][e[+-]digits]  (also .digits)
+// Return 1 if valid, 0 otherwise.
+static int checkinput (const char *str, XTime::TimeFormat tForm, int hexfmt, int nmday)
+{
+  const char *s = str ;
+  int i ;
+
+  switch (tForm) {
+  case XTime::DATE :
+    if ( ( s = scandigits (s, 4, 4) ) == NULL || ( *s++ != ':' ) )
+      return 0 ;
+    if ( ( s = scandigits (s, 3, 3) ) == NULL || ( *s++ != ':' ) )
+      return 0 ;
+    return scanfields (s, 3, 2, 2, ':') ;
+  case XTime::FITS :
+    if ( ( s = scandigits (s, 4, 4) ) == NULL || ( *s++ != '-' ) )
+      return 0 ;
+    if ( ( s = scandigits (s, 1, 2) ) == NULL || ( *s++ != '-' ) )
+      return 0 ;
+    if ( ( s = scandigits (s, 1, 2) ) == NULL || ( *s++ != 'T' ) )
+      return 0 ;
+    return scanfields (s, 3, 1, 2, ':') ;
+  case XTime::CALDATE :
+    if ( ( s = scandigits (s, 4, 4) ) == NULL )
+      return 0 ;
+    for (i=0; i<3; i++)
+      if ( !isalpha ((unsigned char) *s++) )
+	return 0 ;
+    if ( ( s = scandigits (s, 1, 2) ) == NULL || !isspace ((unsigned char) *s) )
+      return 0 ;
+    while ( isspace ((unsigned char) *s) )
+      s++ ;
+    if ( strncmp (s, "at", 2) || !isspace ((unsigned char) s[2]) )
+      return 0 ;
+    s += 2 ;
+    while ( isspace ((unsigned char) *s) )
+      s++ ;
+    return scanfields (s, 3, 1, 2, ':') ;
+  default:
+    break ;
+  }
+
+  if ( nmday ) {
+    if ( ( s = scandigits (s, 1, 4) ) == NULL || ( *s++ != ':' ) )
+      return 0 ;
+    return scanfields (s, 3, 1, 2, ':') ;
+  }
+  if ( hexfmt ) {
+    if ( ( s[0] == '0' ) && ( ( s[1] == 'x' ) || ( s[1] == 'X' ) ) )
+      s += 2 ;
+    for (i=0; isxdigit ((unsigned char) s[i]); i++) ;
+    return i && !s[i] ;
+  }
+
+  // Plain number
+  if ( ( *s == '+' ) || ( *s == '-' ) )
+    s++ ;
+  if ( isdigit ((unsigned char) *s) ) {
+    s = scandigits (s, 1, INT_MAX) ;
+    if ( *s == '.' )
+      s = scandigits (s+1, 0, INT_MAX) ;
+  }
+  else if ( ( *s == '.' ) && isdigit ((unsigned char) s[1]) )
+    s = scandigits (s+1, 1, INT_MAX) ;
+  else
+    return 0 ;
+  if ( ( *s == 'e' ) || ( *s == 'E' ) ) {
+    s++ ;
+    if ( ( *s == '+' ) || ( *s == '-' ) )
+      s++ ;
+    if ( ( s = scandigits (s, 1, INT_MAX) ) == NULL )
+      return 0 ;
+  }
+  return !*s ;
+}
+
+//
+//   -----------------
+// -- _convert_buffer --
+//   -----------------
+//
+//<num_in> <str_in> <in_width> <in_charsize> <n> <ts_in> <tf_in> <ts_out> <tf_out>
+//<num_out> <str_out> <out_width> <out_charsize> <valid>
+//
+//  num_in       Array of n numeric input times, or NULL for string input
+//  str_in       Buffer of n fixed-width input strings (if num_in is NULL)
+//  in_width     Width of an input string in characters
+//  in_charsize  Bytes per input character: 1 (ASCII) or 4 (UCS4)
+//  n            Number of times
+//  ts_in        Time system of input times
+//  tf_in        Time format of input times
+//  ts_out       Time system of output times
+//  tf_out       Time format of output times
+//  num_out      Array of n numeric output times, or NULL for string output
+//  str_out      Buffer of n fixed-width output strings (if num_out is NULL)
+//  out_width    Width of an output string in characters
+//  out_charsize Bytes per output character: 1 (ASCII) or 4 (UCS4)
+//  valid        Array of n validity flags, or NULL to skip validation
+//
+// Description:
+// Batch conversion using a single XTime object, reading and writing
+// the caller's buffers in place (e.g. numpy float64, S and U arrays).
+// The system and format codes are those of axTime3.  Numeric output
+// is only allowed for SECS, JD, and MJD; it is rounded like the
+// "%.9f" output of axTime3.  Seconds between UTC and another system
+// are converted by XTime::convertSecs, to the same results.
+// If valid is given, each input is checked first (finite number, or
+// string of the syntax described at checkinput, with a known month
+// name) and valid[i] is set to 1 or 0; invalid inputs are not
+// converted and give NaN or an empty string.  Without valid the
+// inputs are trusted, like axTime3 itself.
+// With valid, an output string longer than out_width (a time out of
+// range, e.g. past the year 9999) is not truncated either: valid[i]
+// is set to 0 and the record left empty.
+// Return 0 on success, 1 for a bad input and 2 for a bad output
+// system or format code; nothing is converted on error.
+// The conversions use the global leap second table and MJDref; see
+// _convert_buffer_context for those of a time context.
+int _convert_buffer (const double *num_in,
+                     const void *str_in,
+                     int in_width,
+                     int in_charsize,
+                     long n,
+                     char *ts_in,
+                     char *tf_in,
+                     char *ts_out,
+                     char *tf_out,
+                     double *num_out,
+                     void *str_out,
+                     int out_width,
+                     int out_charsize,
+                     unsigned char *valid
+    ) {
+  return _convert_buffer_context (num_in, str_in, in_width, in_charsize, n,
+                                  ts_in, tf_in, ts_out, tf_out, num_out, str_out,
+                                  out_width, out_charsize, valid, NULL) ;
+}
+
+//
+//   -------------------------
+// -- _convert_buffer_context --
+//   -------------------------
+//
+//<num_in> <str_in> <in_width> <in_charsize> <n> <ts_in> <tf_in> <ts_out> <tf_out>
+//<num_out> <str_out> <out_width> <out_charsize> <valid> <context>
+//
+//  context      Time context (from _context_read or _context_table), or
+//               NULL for the global one
+//
+// Description:
+// _convert_buffer with the leap second table and the default MJDref
+// of time context context (see XTimeContext).
+int _convert_buffer_context (const double *num_in,
+                     const void *str_in,
+                     int in_width,
+                     int in_charsize,
+                     long n,
+                     char *ts_in,
+                     char *tf_in,
+                     char *ts_out,
+                     char *tf_out,
+                     double *num_out,
+                     void *str_out,
+                     int out_width,
+                     int out_charsize,
+                     unsigned char *valid,
+                     const void *context
+    ) {
+  const XTimeContext &ctx = context ? *(const XTimeContext *) context
+    : XTimeContext::global () ;
+  XTime T (ctx) ;
+  XTime::TimeSys tSysIn, tSysOut ;
+  XTime::TimeFormat tFormIn, tFormOut ;
+  int hexIn, nmdayIn, hexOut, nmdayOut ;
+  int decIn = 0 ;
+  int dec = 0 ;
+  char str[256] ;
+  long i ;
+
+  XTSTAT_CALL (XTA_CONVERT_BUFFER) ;
+  XTTRACE_SPAN ("_convert_buffer", "axTime3") ;
+  if ( readsys (ts_in, &tSysIn) || readform (tf_in, &tFormIn, &hexIn, &nmdayIn, &decIn) )
+    return 1 ;
+  if ( num_in && ( tFormIn > XTime::MJD ) )
+    return 1 ;
+  if ( readsys (ts_out, &tSysOut) || readform (tf_out, &tFormOut, &hexOut, &nmdayOut, &dec) )
+    return 2 ;
+  if ( num_out && ( ( tFormOut > XTime::MJD ) || hexOut || nmdayOut ) )
+    return 2 ;
+
+//  Seconds to seconds between UTC and the other systems: by the UTC
+//  offset segments, without an XTime per time
+  if ( num_in && num_out && ( tFormIn == XTime::SECS ) && ( tFormOut == XTime::SECS )
+       && ( ( tSysIn == XTime::UTC ) != ( tSysOut == XTime::UTC ) ) ) {
+    XTime::convertSecs (num_in, num_out, n, tSysOut == XTime::UTC, ctx.utcSegments ()) ;
+    for (i=0; i<n; i++) {
+      if ( valid ) {
+	valid[i] = isfinite (num_in[i]) ;
+	if ( !valid[i] ) {
+	  XTSTAT_COUNT (XTS_INPUT_REJECTED) ;
+	  continue ;
+	}
+      }
+      num_out[i] = round9 (num_out[i]) ;
+      XTSTAT_COUNT (XTS_BUFFER_CONVERTED) ;
+    }
+    return 0 ;
+  }
+
+  for (i=0; i<n; i++) {
+    XTSTAT_TIME (XTH_BUFFER) ;
+    XTTRACE_ELEMENT () ;
+
+//    Get the time
+    int ok ;
+    if ( num_in ) {
+      XTTRACE_SPAN ("getinput", "axTime3") ;
+      ok = isfinite (num_in[i]) ;
+      if ( ok || !valid )
+	T.set (num_in[i], tSysIn, tFormIn) ;
+    }
+    else {
+      XTTRACE_SPAN ("getinput", "axTime3") ;
+      ok = !getrecord (str_in, i, in_width, in_charsize, str, sizeof (str))
+	&& ( !valid || checkinput (str, tFormIn, hexIn, nmdayIn) ) ;
+      if ( ok )
+	ok = !setinput (&T, str, tSysIn, tFormIn, hexIn, nmdayIn) ;
+    }
+    if ( valid ) {
+      valid[i] = ok ;
+      if ( !ok ) {
+	XTSTAT_COUNT (XTS_INPUT_REJECTED) ;
+	if ( num_out )
+	  num_out[i] = NAN ;
+	else
+	  putrecord (str_out, i, out_width, out_charsize, "") ;
+	continue ;
+      }
+    }
+
+//    Convert and store the result
+    if ( num_out ) {
+      XTTRACE_SPAN ("putoutput", "axTime3") ;
+      num_out[i] = round9 (T.get (tSysOut, tFormOut)) ;
+    }
+    else {
+      putoutput (&T, tSysOut, tFormOut, hexOut, nmdayOut, dec, str) ;
+      // A time out of range gives a string too long for the record
+      if ( valid && ( (int) strlen (str) > out_width ) ) {
+	valid[i] = 0 ;
+	XTSTAT_COUNT (XTS_INPUT_REJECTED) ;
+	putrecord (str_out, i, out_width, out_charsize, "") ;
+	continue ;
+      }
+      putrecord (str_out, i, out_width, out_charsize, str) ;
+    }
+    XTSTAT_COUNT (XTS_BUFFER_CONVERTED) ;
+  }
+
+  return 0 ;
+}
+
+//
+//   ----------------
+// -- _convert_nanos --
+//   ----------------
+//
+//<nanos_in> <nanos_out> <n> <ts_in> <ts_out> <context>
+//
+//  nanos_in    Array of n times in nanoseconds since MJDref, time system ts_in
+//  nanos_out   Array of n times in nanoseconds since MJDref, time system ts_out
+//  n           Number of times
+//  ts_in       Time system of input times
+//  ts_out      Time system of output times
+//  context     Time context, or NULL for the global one
+//
+// Description:
+// Batch conversion of integer nanoseconds (the SECS format, in ns)
+// by XTime::convertNanos: exact, in integer arithmetic.  MET, TT, and
+// TAI nanoseconds are the same.  Return 0 on success, 1 for a bad
+// input and 2 for a bad output system code.
+int _convert_nanos (const long long *nanos_in,
+                    long long *nanos_out,
+                    long n,
+                    char *ts_in,
+                    char *ts_out,
+                    const void *context
+    ) {
+  XTime::TimeSys tSysIn, tSysOut ;
+  if ( readsys (ts_in, &tSysIn) )
+    return 1 ;
+  if ( readsys (ts_out, &tSysOut) )
+    return 2 ;
+  const XTimeContext &ctx = context ? *(const XTimeContext *) context
+    : XTimeContext::global () ;
+  if ( ( tSysIn == XTime::UTC ) != ( tSysOut == XTime::UTC ) )
+    XTime::convertNanos (nanos_in, nanos_out, n, tSysOut == XTime::UTC, ctx.utcSegments ()) ;
+  else if ( nanos_out != nanos_in )
+    memcpy (nanos_out, nanos_in, n * sizeof (long long)) ;
+  return 0 ;
+}
+
+//
+//   ---------------
+// -- _convert_hilo --
+//   ---------------
+//
+//<hi_in> <lo_in> <n> <ts_in> <tf_in> <ts_out> <tf_out> <hi_out> <lo_out> <context>
+//
+//  hi_in       Array of n numeric times in time system ts_in, format tf_in
+//  lo_in       Array of n low parts of the times, or NULL
+//  n           Number of times
+//  ts_in       Time system of input times
+//  tf_in       Time format of input times (SECS, JD, or MJD)
+//  ts_out      Time system of output times
+//  tf_out      Time format of output times (SECS, JD, or MJD)
+//  hi_out      Array of n numeric times in time system ts_out, format tf_out
+//  lo_out      Array of n low parts of the output times
+//  context     Time context, or NULL for the global one
+//
+// Description:
+// Batch conversion of numeric times as double-doubles hi+lo, by
+// XTime::getHiLo: a JD or MJD keeps the full precision of the time,
+// which a single double does not near the present epoch.  The whole
+// units of the input are split off before it is set, so that only its
+// fraction is rounded.  Non-finite times give NaN.  Return 0 on
+// success, 1 for a bad input and 2 for a bad output system or format.
+int _convert_hilo (const double *hi_in,
+                   const double *lo_in,
+                   long n,
+                   char *ts_in,
+                   char *tf_in,
+                   char *ts_out,
+                   char *tf_out,
+                   double *hi_out,
+                   double *lo_out,
+                   const void *context
+    ) {
+  XTime::TimeSys tSysIn, tSysOut ;
+  XTime::TimeFormat tFormIn, tFormOut ;
+  int hex, nmday, dec ;
+  long i, k ;
+  double lo ;
+
+  if ( readsys (ts_in, &tSysIn) || readform (tf_in, &tFormIn, &hex, &nmday, &dec)
+       || ( tFormIn > XTime::MJD ) )
+    return 1 ;
+  if ( readsys (ts_out, &tSysOut) || readform (tf_out, &tFormOut, &hex, &nmday, &dec)
+       || ( tFormOut > XTime::MJD ) || hex || nmday )
+    return 2 ;
+  const XTimeContext &ctx = context ? *(const XTimeContext *) context
+    : XTimeContext::global () ;
+  XTime T (ctx) ;
+
+  for (i=0; i<n; i++) {
+    lo = lo_in ? lo_in[i] : 0.0 ;
+    if ( !isfinite (hi_in[i]) || !isfinite (lo) ) {
+      hi_out[i] = lo_out[i] = NAN ;
+      continue ;
+    }
+    k = (long) floor (hi_in[i]) ;
+    T.set (k, ( hi_in[i] - k ) + lo, tSysIn, tFormIn) ;
+    hi_out[i] = T.getHiLo (lo_out + i, tSysOut, tFormOut) ;
+  }
+  return 0 ;
+}
+
+//
+//   ----------------
+// -- _convert_array --
+//   ----------------
+//
+//<time_in> <time_out> <n> <ts_in> <tf_in> <ts_out> <tf_out>
+//
+//  time_in     Array of n numeric times in time system ts_in, format tf_in
+//  time_out    Array of n numeric times in time system ts_out, format tf_out
+//  n           Number of times
+//
+// Description:
+// Batch conversion of numeric times (SECS, JD, or MJD); see _convert_buffer.
+int _convert_array (const double *time_in,
+                    double *time_out,
+                    long n,
+                    char *ts_in,
+                    char *tf_in,
+                    char *ts_out,
+                    char *tf_out
+    ) {
+  return _convert_buffer (time_in, NULL, 0, 0, n, ts_in, tf_in, ts_out, tf_out,
+                          time_out, NULL, 0, 0, NULL) ;
+}
+
+//
+//   --------------
+// -- _time_fields --
+//   --------------
+//
+//<secs> <n> <dec> <year> <yday> <month> <mday> <hour> <minute> <second> <wday>
+//
+//  secs        Array of n times in MET seconds
+//  dec         Number of decimals to which second is rounded
+//  year ...    Output arrays of n UTC calendar fields (see XTime::getFields)
+//  wday        Output array of n days of the week (0-6, where 0 is Monday)
+//
+// Description:
+// Batch decomposition of MET seconds into UTC calendar fields.  The
+// day of the week is that of the UTC MJD (as converted, to 9
+// decimals), not of the rounded date: just before midnight it can
+// be the previous day, and in a leap second the next one.
+void _time_fields (const double *secs,
+                   long n,
+                   int dec,
+                   int *year,
+                   int *yday,
+                   int *month,
+                   int *mday,
+                   int *hour,
+                   int *minute,
+                   double *second,
+                   int *wday
+    ) {
+  XTime T ;
+  long i, k ;
+
+  for (i=0; i<n; i++) {
+    T.set (secs[i], XTime::MET, XTime::SECS) ;
+    T.getFields (year+i, yday+i, month+i, mday+i,
+                 hour+i, minute+i, second+i, XTime::UTC, dec) ;
+    // MJD 0 was a Wednesday
+    k = (long) floor (round9 (T.get (XTime::UTC, XTime::MJD))) ;
+    wday[i] = (k + 2) % 7 ;
+  }
+  return ;
+}
+
+//
+//   ------------
+// -- _day_start --
+//   ------------
+//
+//<secs> <secs_out> <n> <ndays>
+//
+//  secs        Array of n times in MET seconds
+//  secs_out    Array of n output times in MET seconds
+//  ndays       Number of days to add to the start of the day
+//
+// Description:
+// Batch computation of the start of the UTC day (as shown in the
+// date string with 3 decimals) plus ndays, in MET seconds.
+void _day_start (const double *secs,
+                 double *secs_out,
+                 long n,
+                 int ndays
+    ) {
+  XTime T ;
+  int year, yday, month, mday, hour, minute ;
+  double second ;
+  long i, k ;
+
+  for (i=0; i<n; i++) {
+    T.set (secs[i], XTime::MET, XTime::SECS) ;
+    k = T.getFields (&year, &yday, &month, &mday,
+                     &hour, &minute, &second, XTime::UTC, 3) ;
+    T.set (k + ndays, 0.0, XTime::UTC, XTime::MJD) ;
+    secs_out[i] = round9 (T.get (XTime::MET, XTime::SECS)) ;
+  }
+  return ;
+}
+
+//
+//   ---------------
+// -- _context_read --
+//   ---------------
+//
+//<file> <mjdrefi> <mjdreff> <num>
+//
+//  file        Leap seconds file, in the format of tai-utc.dat
+//  mjdrefi     Default MJDref of the context (integer part, TT; 0 for 1998.0)
+//  mjdreff     Default MJDref of the context (fractional part)
+//  num         Number of entries, 0 if the file could not be read, or
+//              minus the number of the first line that is wrong
+//
+// Description:
+// Make a time context with the leap seconds of file (see
+// XTime::readLeaps).  Return the context, to be freed with
+// _context_free, or NULL if the file could not be used.
+void *_context_read (const char *file,
+                     long mjdrefi,
+                     double mjdreff,
+                     int *num
+    ) {
+  XTimeLeapTable leaps ;
+  *num = XTime::readLeaps (file, &leaps) ;
+  if ( *num <= 0 )
+    return NULL ;
+  snprintf (leaps.file, sizeof (leaps.file), "%s", file) ;
+  return new XTimeContext (leaps, mjdrefi, mjdreff) ;
+}
+
+//
+//   ----------------
+// -- _context_table --
+//   ----------------
+//
+//<mjd> <secs> <n> <mjdrefi> <mjdreff>
+//
+//  mjd         Array of n leap second dates (UTC MJD), or NULL for the
+//              table in use for the global context
+//  secs        Array of n values of TAI-UTC from those dates
+//  mjdrefi     Default MJDref of the context (integer part, TT; 0 for 1998.0)
+//  mjdreff     Default MJDref of the context (fractional part)
+//
+// Description:
+// Make a time context with a copy of the given leap seconds.  The
+// dates must increase and TAI-UTC must not decrease, as in a leap
+// seconds file.  Return the context, to be freed with _context_free,
+// or NULL if the table is empty or out of order.
+void *_context_table (const long *mjd,
+                      const double *secs,
+                      int n,
+                      long mjdrefi,
+                      double mjdreff
+    ) {
+  XTimeLeapTable leaps ;
+  if ( mjd == NULL ) {
+    const XTimeLeapTable *global = XTimeContext::global ().leapTable () ;
+    mjd = global->mjd.data () ;
+    secs = global->secs.data () ;
+    n = global->num ;
+  }
+  if ( n <= 0 )
+    return NULL ;
+  for (int i=1; i<n; i++)
+    if ( ( mjd[i] <= mjd[i-1] ) || ( secs[i] < secs[i-1] ) )
+      return NULL ;
+  leaps.mjd.assign (mjd, mjd + n) ;
+  leaps.secs.assign (secs, secs + n) ;
+  leaps.num = n ;
+  return new XTimeContext (leaps, mjdrefi, mjdreff) ;
+}
+
+//
+//   ---------------
+// -- _context_free --
+//   ---------------
+//
+//<context>
+//
+//  context     Time context from _context_read or _context_table
+//
+// Description:
+// Free a time context; no conversion may be using it.
+void _context_free (void *context) {
+  delete (XTimeContext *) context ;
+}
+
+//
+//   ----------------
+// -- _context_leaps --
+//   ----------------
+//
+//<context> <mjd> <secs> <file>
+//
+//  context     Time context, or NULL for the global one
+//  mjd         Leap second dates (UTC MJD) of the context
+//  secs        TAI-UTC from those dates
+//  file        File they were read from ("" if built in or given)
+//
+// Description:
+// Return the number of leap second entries of a time context and
+// point mjd, secs and file to them.
+int _context_leaps (const void *context,
+                    const long **mjd,
+                    const double **secs,
+                    const char **file
+    ) {
+  const XTimeContext &ctx = context ? *(const XTimeContext *) context
+    : XTimeContext::global () ;
+  const XTimeLeapTable *leaps = ctx.leapTable () ;
+  *mjd = leaps->mjd.data () ;
+  *secs = leaps->secs.data () ;
+  *file = leaps->file ;
+  return leaps->num ;
+}
+
+//
+//   ------------
+// -- _leap_info --
+//   ------------
+//
+//<file> <readtime> <fallback> <lookups>
+//
+//  file        Leap seconds file that was read ("" if none)
+//  readtime    Time taken by the last lookup and read of the file (s)
+//  fallback    1 if the built-in leap seconds are in use
+//  lookups     Number of times the file was looked for
+//
+// Description:
+// Report where the leap second table came from, loading it first
+// if that has not been done yet.  Return the number of entries.
+int _leap_info (const char **file,
+                double *readtime,
+                int *fallback,
+                int *lookups
+    ) {
+  XTime T ;
+  *lookups = T.leapLookups () ;
+  return T.leapSource (file, readtime, fallback) ;
+}
+
+//
+//   --------------
+// -- _leap_refresh --
+//   --------------
+//
+//<force>
+//
+//  force       Read the leap seconds file even if it did not change
+//
+// Description:
+// Check the leap seconds file now, and read it if it changed (or
+// if force).  Return the number of entries in the table.
+int _leap_refresh (int force) {
+  XTime T ;
+  T.setLeaps (force ? -1.0 : 0.0) ;
+  const long *mjds ;
+  return T.leapDates (&mjds) ;
+}
+
+//
+//   ---------------
+// -- _leap_interval --
+//   ---------------
+//
+//<interval>
+//
+//  interval    Seconds between checks of the leap seconds file;
+//              left unchanged if negative
+//
+// Description:
+// Set the interval at which the leap seconds file is checked for
+// changes; return the previous one.
+double _leap_interval (double interval) {
+  double old = XTime::setLeapsInterval (interval) ;
+  if ( interval < 0.0 )
+    XTime::setLeapsInterval (old) ;
+  return old ;
+}
+
 
 //
 //   ----------
@@ -321,6 +1112,94 @@ XTime *getinput (int argc, char *argv[])
   return tt ;
 }
 
+//
+//   ----------
+// -- setinput --
+//   ----------
+//
+
+// Description:
+// Set XTime object T from string str holding a time in time system
+// tSys and format tForm (hexfmt and nmday as returned by readform).
+// The format is known, so none of the guessing of getinput is done.
+// Return 0 on success, 1 if a date string could not be parsed
+// (T is then unchanged).
+int setinput (XTime *T, const char *str, XTime::TimeSys tSys,
+	      XTime::TimeFormat tForm, int hexfmt, int nmday)
+{
+  double t ;
+  unsigned int jt = 0 ;
+  int day = 0 ;
+  int h = 0 ;
+  int m = 0 ;
+
+  switch (tForm) {
+  case XTime::DATE : case XTime::CALDATE : case XTime::FITS :
+    return T->set (str, tSys, tForm) ;
+  default:
+    if ( hexfmt ) {
+      sscanf (str, "%x", &jt) ;
+      t = jt ;
+    }
+    else if ( nmday ) {
+      t = 0.0 ;
+      sscanf (str, "%d:%d:%d:%lg", &day, &h, &m, &t) ;
+      t += 86400 * day + 3600 * h + 60 * m ;
+    }
+    else
+      t = atof (str) ;
+    T->set (t, tSys, tForm) ;
+    break ;
+  }
+  return 0 ;
+}
+
+//
+//   -----------
+// -- putoutput --
+//   -----------
+//
+
+// Description:
+// Print the time of XTime object T in time system tSys and format
+// tForm (hexfmt, nmday, and dec as returned by readform) to time_out.
+void putoutput (XTime *T, XTime::TimeSys tSys, XTime::TimeFormat tForm,
+		int hexfmt, int nmday, int dec, char *time_out)
+{
+  XTTRACE_SPAN ("putoutput", "axTime3") ;
+  switch (tForm) {
+  case XTime::SECS : case XTime::JD : case XTime::MJD : {
+    double t = T->get(tSys, tForm) ;
+    if ( hexfmt ) {
+      unsigned int jt = (unsigned long) t ;
+      sprintf(time_out, "0x%7x", jt);
+      //	  cout << "0x" << setw(7) << hex << jt ;
+    }
+    else if ( nmday ) {
+      int day = (int) t / 86400 ;
+      t -= day * 86400 ;
+      int h = (int) t / 3600 ;
+      t -= h * 3600 ;
+      int m = (int) t / 60 ;
+      t -= m * 60 ;
+      sprintf(time_out, "%d:%d:%d:%.10f", day, h, m, t);
+      //	  cout << dec << day << ":" << h << ":" << m << ":"
+      //	       << setprecision(10) << t ;
+    }
+    else 
+      //	  cout << setprecision(18) << t ;
+      sprintf(time_out, "%.9f", t);
+    break ;
+  }
+  case XTime::DATE : case XTime::CALDATE : case XTime::FITS : {
+    const char *s = T->getDate(tSys, tForm, dec) ;
+    sprintf(time_out, "%s", s);
+    break ;
+  }
+  }
+  return ;
+}
+
 //
 //   ---------
 // -- readsys --
@@ -5,3 +5,101 @@ void _convert_time(char *time_in,
                     char *tf_out,
                     char *time_out
     );
+int _convert_array(const double *time_in,
+                   double *time_out,
+                   long n,
+                   char *ts_in,
+                   char *tf_in,
+                   char *ts_out,
+                   char *tf_out
+    );
+void _time_fields(const double *secs,
+                  long n,
+                  int dec,
+                  int *year,
+                  int *yday,
+                  int *month,
+                  int *mday,
+                  int *hour,
+                  int *minute,
+                  double *second,
+                  int *wday
+    );
+void _day_start(const double *secs,
+                double *secs_out,
+                long n,
+                int ndays
+    );
+int _convert_buffer(const double *num_in,
+                    const void *str_in,
+                    int in_width,
+                    int in_charsize,
+                    long n,
+                    char *ts_in,
+                    char *tf_in,
+                    char *ts_out,
+                    char *tf_out,
+                    double *num_out,
+                    void *str_out,
+                    int out_width,
+                    int out_charsize,
+                    unsigned char *valid
+    );
+int _convert_buffer_context(const double *num_in,
+                            const void *str_in,
+                            int in_width,
+                            int in_charsize,
+                            long n,
+                            char *ts_in,
+                            char *tf_in,
+                            char *ts_out,
+                            char *tf_out,
+                            double *num_out,
+                            void *str_out,
+                            int out_width,
+                            int out_charsize,
+                            unsigned char *valid,
+                            const void *context
+    );
+int _convert_nanos(const long long *nanos_in,
+                   long long *nanos_out,
+                   long n,
+                   char *ts_in,
+                   char *ts_out,
+                   const void *context
+    );
+int _convert_hilo(const double *hi_in,
+                  const double *lo_in,
+                  long n,
+                  char *ts_in,
+                  char *tf_in,
+                  char *ts_out,
+                  char *tf_out,
+                  double *hi_out,
+                  double *lo_out,
+                  const void *context
+    );
+void *_context_read(const char *file,
+                    long mjdrefi,
+                    double mjdreff,
+                    int *num
+    );
+void *_context_table(const long *mjd,
+                     const double *secs,
+                     int n,
+                     long mjdrefi,
+                     double mjdreff
+    );
+void _context_free(void *context);
+int _context_leaps(const void *context,
+                   const long **mjd,
+                   const double **secs,
+                   const char **file
+    );
+int _leap_info(const char **file,
+               double *readtime,
+               int *fallback,
+               int *lookups
+    );
+int _leap_refresh(int force);
+double _leap_interval(double interval);
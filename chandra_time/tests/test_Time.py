@@ -1,10 +1,15 @@
 # Licensed under a 3-clause BSD style license - see LICENSE.rst
 
+import os
 import time
 import numpy as np
 import pytest
 
-from ..Time import DateTime, convert, convert_vals, date2secs, secs2date, use_noon_day_start
+from ..Time import (DateTime, convert, convert_vals, date2secs, secs2date, use_noon_day_start,
+                    conversion_stats, reset_conversion_stats, leap_table_info,
+                    refresh_leap_table, set_leap_check_interval, time_context,
+                    secs2nanos, nanos2secs, convert_nanos, convert_hilo,
+                    start_conversion_trace, stop_conversion_trace)
 from cxotime import CxoTime
 from astropy.time import Time
 
@@ -48,6 +53,357 @@ def test_date2secs(date_in):
     assert np.all(date2secs(date_in_bytes) == vals.secs)
 
 
+def test_convert_vals_string_buffers():
+    """S and U arrays of any width, order and stride convert like lists."""
+    dates = ['2012:001:00:00:00.000', '2016:366:23:59:60.500', '1999:200:12:34:56.789',
+             '2030:365:01:02:03.004', '1997:365:23:58:56.816', '2005:100:00:00:00.000']
+    exp = np.array([date2secs(date) for date in dates])
+    for dtype in ('S21', 'U21', 'S32', 'U40', '>U21'):
+        vals = np.array(dates, dtype=dtype)
+        assert np.all(convert_vals(vals, 'date', 'secs') == exp)
+        assert np.all(convert_vals(vals[::2], 'date', 'secs') == exp[::2])
+        vals2d = np.asfortranarray(vals.reshape(2, 3))
+        assert np.all(convert_vals(vals2d, 'date', 'secs') == exp.reshape(2, 3))
+        out = convert_vals(vals[::-1], 'date', 'date')
+        assert out.dtype == np.dtype('U21')
+        assert out.tolist() == dates[::-1]
+
+
+def test_convert_vals_invalid():
+    dates = ['2012:001:00:00:00.000', 'junk', '2012:001:00:00', '2012Xyz01 at 00:00:00']
+    with pytest.raises(ValueError, match=r'index 1 .*3 invalid of 4'):
+        date2secs(dates)
+    with pytest.raises(ValueError):
+        secs2date(np.nan)
+
+    secs, valid = convert_vals(dates, 'date', 'secs', return_valid=True)
+    assert np.all(valid == [True, False, False, False])
+    assert secs[0] == date2secs(dates[0])
+    assert np.all(np.isnan(secs[1:]))
+
+    secs, valid = convert_vals(dates[3], 'caldate', 'secs', return_valid=True)
+    assert valid is False
+
+
+def test_convert_vals_out_of_range():
+    """Times whose strings do not fit the output width raise, not truncate."""
+    with pytest.raises(ValueError, match='invalid secs input'):
+        secs2date(1e13)
+    with pytest.raises(ValueError):
+        DateTime(1e13, format='secs').date
+    dates, valid = convert_vals([1e13, 0.0], 'secs', 'date', return_valid=True)
+    assert dates.tolist() == ['', '1997:365:23:58:56.816']
+    assert valid.tolist() == [False, True]
+
+
+def test_datetime_cache(monkeypatch):
+    """The input is converted once; every format matches the uncached conversion."""
+    from .. import Time as time_module
+    calls = []
+    uncached = time_module.convert
+
+    def counting_convert(*args, **kwargs):
+        calls.append(kwargs.get('fmt_in'))
+        return uncached(*args, **kwargs)
+
+    monkeypatch.setattr(time_module, 'convert', counting_convert)
+    t = DateTime('2012:061:12:34:56.789')
+    assert t.date == '2012:061:12:34:56.789'
+    assert t.secs == uncached('2012:061:12:34:56.789', fmt_out='secs')
+    assert t.jd == uncached('2012:061:12:34:56.789', fmt_out='jd')
+    assert calls == [None]
+    monkeypatch.undo()
+
+    fmts = ['fits', 'year_mon_day', 'greta', 'secs', 'frac_year', 'unix', 'iso',
+            'caldate', 'date', 'year_doy', 'jd', 'mjd', 'numday', 'plotdate']
+    np.random.seed(4)
+    secs = np.random.uniform(1e7, 1.5e9, 100)
+    inputs = [('2016:366:23:59:60.500', None), ('2015-06-30 23:59:60.250', None),
+              (2455000.25, 'jd'), (secs, None), (np.array(secs2date(secs)), None),
+              (DateTime(secs).iso.tolist(), None), (DateTime(secs).greta.tolist(), None)]
+    for time_in, fmt_in in inputs:
+        for fmt in fmts:
+            out = getattr(DateTime(time_in, format=fmt_in), fmt)
+            exp = convert(time_in, fmt_in=fmt_in, fmt_out=fmt)
+            assert type(out) is type(exp)
+            if np.asarray(exp).dtype.kind == 'f':
+                assert np.allclose(out, exp, rtol=1e-15, atol=0)
+            else:
+                assert np.all(np.asarray(out) == np.asarray(exp))
+
+
+def test_leap_table_info():
+    info = leap_table_info()
+    assert info['entries'] >= 28
+    assert info['lookups'] >= 1
+    assert info['read_time'] >= 0
+    if info['fallback']:
+        assert info['file'] == ''
+    else:
+        assert info['file'].endswith('tai-utc.dat')
+
+
+def test_leap_table_refresh(tmp_path, monkeypatch):
+    taiutc = os.path.join(os.path.dirname(os.path.dirname(__file__)), 'tai-utc.dat')
+    if not os.path.exists(taiutc):
+        pytest.skip('no tai-utc.dat in the source tree')
+    with open(taiutc) as fh:
+        lines = fh.read()
+    entries = leap_table_info()['entries']
+    leapfile = tmp_path / 'tai-utc.dat'
+    leapfile.write_text(lines + ' 2028 JAN  1 =JD 2461771.5  TAI-UTC=  38.0       S'
+                        ' + (MJD - 41317.) X 0.0      S\n')
+    monkeypatch.setenv('TIMING_DIR', str(tmp_path))
+    try:
+        info = refresh_leap_table()
+        assert info['file'] == str(leapfile)
+        assert info['entries'] == entries + 1
+        assert date2secs('2028:001:00:00:00') - date2secs('2027:365:00:00:00') == 86401
+
+        # Unchanged file: checked, not read
+        reset_conversion_stats()
+        info = refresh_leap_table()
+        assert info['entries'] == entries + 1
+        stats = conversion_stats()
+        if stats is not None:
+            assert stats['counters']['leaps_read'] == 0
+    finally:
+        leapfile.write_text(lines)
+        info = refresh_leap_table(force=True)
+    assert info['entries'] == entries
+    assert date2secs('2028:001:00:00:00') - date2secs('2027:365:00:00:00') == 86400
+
+    interval = set_leap_check_interval(0)
+    assert set_leap_check_interval(interval) == 0
+
+
+def test_leap_table_validation(tmp_path, monkeypatch):
+    taiutc = os.path.join(os.path.dirname(os.path.dirname(__file__)), 'tai-utc.dat')
+    if not os.path.exists(taiutc):
+        pytest.skip('no tai-utc.dat in the source tree')
+    with open(taiutc) as fh:
+        lines = fh.read()
+    entries = leap_table_info()['entries']
+    line = (' {} JAN  1 =JD {}.5  TAI-UTC=  {:.1f}       S + (MJD - 41317.) X 0.0      S\n')
+    leapfile = tmp_path / 'tai-utc.dat'
+    monkeypatch.setenv('TIMING_DIR', str(tmp_path))
+    try:
+        # Any number of leap seconds
+        leapfile.write_text(lines + ''.join(line.format(2028 + k, 2461771 + 365 * k, 38.0 + k)
+                                            for k in range(100)))
+        info = refresh_leap_table(force=True)
+        assert info['entries'] == entries + 100
+        assert date2secs('2028:001:00:00:00') - date2secs('2027:365:00:00:00') == 86401
+
+        # Dates out of order or a bad line: the file is not used
+        for bad in (line.format(2016, 2457754, 38.0), ' 2028 JAN  1 =JD 2461771.5  junk\n'):
+            leapfile.write_text(lines + bad)
+            info = refresh_leap_table(force=True)
+            assert info['entries'] == entries + 100
+    finally:
+        leapfile.write_text(lines)
+        info = refresh_leap_table(force=True)
+    assert info['entries'] == entries
+
+
+def test_convert_utc_secs():
+    """Seconds between UTC and the other systems go by the UTC offset
+    segments; they must match axTime3, also in and around a leap second."""
+    from .. import _axTime3 as axTime3
+    np.random.seed(0)
+    times = np.concatenate([np.arange(599615990.0, 599616080.0, 0.125),
+                            np.random.uniform(-5e8, 1.5e9, 500),
+                            np.random.uniform(-2e7, 2e7, 500)])
+    for sys_in, sys_out in (('m', 'u'), ('u', 'm'), ('t', 'u'), ('u', 'a')):
+        out = axTime3.convert_array(times, sys_in, 's', sys_out, 's')
+        expected = [float(axTime3.convert_time(repr(float(t)), sys_in, 's', sys_out, 's'))
+                    for t in times]
+        assert np.all(out == expected)
+
+    out, valid = axTime3.convert_buffer([599616068.684, np.nan], 'm', 's', 'u', 's',
+                                        np.float64, validate=True)
+    assert valid.tolist() == [True, False]
+    assert out[0] == float(axTime3.convert_time('599616068.684', 'm', 's', 'u', 's'))
+    assert np.isnan(out[1])
+
+
+def test_convert_nanos():
+    """Integer nanoseconds convert exactly: they agree with the float
+    seconds to their precision, round trip outside the leap seconds and step
+    by exactly one second at a leap second."""
+    from .. import _axTime3 as axTime3
+    np.random.seed(1)
+    secs = np.random.uniform(-5e8, 1.5e9, 1000)
+    nanos = secs2nanos(secs)
+    assert nanos.dtype == np.int64
+    assert np.all(np.abs(nanos2secs(nanos) - secs) <= 0.5e-9)
+    assert secs2nanos(599616068.5).tolist() == 599616068500000000
+
+    utc = convert_nanos(nanos, 'tt', 'utc')
+    utc_secs = axTime3.convert_array(secs, 'm', 's', 'u', 's')
+    assert np.all(np.abs(nanos2secs(utc) - utc_secs) < 1e-6)
+    assert np.all(convert_nanos(utc, 'utc', 'tt') == nanos)
+    # End of the 2016:366 leap second (TT), 1 ns before, at and after it
+    step = convert_nanos(599616069184000000 + np.arange(-1, 2), 'tt', 'utc')
+    assert np.diff(step).tolist() == [-999999999, 1]
+    assert np.all(convert_nanos(nanos, 'met', 'tai') == nanos)
+    with pytest.raises(ValueError):
+        convert_nanos(nanos, 'x', 'utc')
+
+
+def test_convert_hilo():
+    """Double-double JD and MJD keep the full precision of the time: exact
+    from an exact MJD, with exact UTC corrections, well below the 20 us of a
+    single float64 JD, and round trip through their low parts."""
+    from fractions import Fraction
+    from .. import _axTime3 as axTime3
+    np.random.seed(2)
+    frac = np.random.uniform(0, 1, 200)
+    hi, lo = convert_hilo(60000.0, 'tt', 'mjd', 'tt', 'jd', lo=frac)
+    for h, l, f in zip(hi, lo, frac):
+        assert Fraction(h) + Fraction(l) == Fraction(2460000.5) + Fraction(f)
+        assert h + l == h
+    # 2020 (TT), when TAI-UTC is 37 s
+    hi, lo = convert_hilo(58849.0, 'tt', 'mjd', 'utc', 'mjd', lo=frac)
+    for h, l, f in zip(hi, lo, frac):
+        exact = 58849 + Fraction(f) - (37 + Fraction(32.184)) / 86400
+        assert abs(Fraction(h) + Fraction(l) - exact) < 1e-24
+
+    secs = np.random.uniform(6e8, 9e8, 200)
+    hi, lo = convert_hilo(secs)
+    single = axTime3.convert_array(secs, 'm', 's', 't', 'j')
+    err = [abs(Fraction(h) + Fraction(l) - Fraction(2450814.5) - Fraction(t) / 86400) * 86400
+           for h, l, t in zip(hi, lo, secs)]
+    assert max(err) < 1e-6
+    assert np.all(np.abs(hi - single) <= np.spacing(single))
+    back, back_lo = convert_hilo(hi, 'tt', 'jd', 'met', 'secs', lo=lo)
+    assert np.all(np.abs((back - secs) + back_lo) < 1e-6)
+    utc, utc_lo = convert_hilo(secs, 'met', 'secs', 'utc', 'secs')
+    utc_single = axTime3.convert_array(secs, 'm', 's', 'u', 's')
+    assert np.all(np.abs((utc - utc_single) + utc_lo) < 1e-6)
+    assert np.all(np.isnan(convert_hilo([np.nan, 1.0], lo=[0.0, np.inf])[0]))
+    with pytest.raises(ValueError):
+        convert_hilo(secs, fmt_out='date')
+
+
+def test_time_context():
+    """A context with a predicted leap second converts with it, side by side
+    with the global table, which it leaves alone."""
+    from concurrent.futures import ThreadPoolExecutor
+    from .. import _axTime3 as axTime3
+    official = time_context()
+    mjd, tai_utc = official.leaps
+    assert len(mjd) == leap_table_info()['entries']
+    predicted = time_context(mjd=np.append(mjd, 61406), tai_utc=np.append(tai_utc, tai_utc[-1] + 1))
+
+    dates = ['2020:001:00:00:00.000', '2026:365:23:59:60.500', '2027:002:00:00:00.000']
+    secs = convert_vals(dates[::2], 'date', 'secs')
+    assert np.all(convert_vals(dates[::2], 'date', 'secs', context=official) == secs)
+    pred = convert_vals(dates, 'date', 'secs', context=predicted)
+    assert pred[0] == secs[0]
+    assert pred[2] == secs[1] + 1
+    assert convert_vals(pred, 'secs', 'date', context=predicted).tolist() == dates
+    utc = axTime3.convert_array(secs, 'm', 's', 'u', 's')
+    assert np.all(axTime3.convert_array(secs, 'm', 's', 'u', 's', context=predicted)
+                  == utc - [0, 1])
+
+    # Own MJDref, one day later
+    shifted = time_context(mjdref=50815.0)
+    assert np.all(convert_vals(dates[::2], 'date', 'secs', context=shifted) == secs - 86400)
+
+    # Both tables at once, in threads
+    times = np.linspace(secs[0], secs[1] + 1e6, 10000)
+    with ThreadPoolExecutor(4) as pool:
+        runs = list(pool.map(lambda ctx: convert_vals(times, 'secs', 'date', context=ctx),
+                             [None, predicted] * 8))
+    assert all(np.all(run == runs[0]) for run in runs[::2])
+    assert all(np.all(run == runs[1]) for run in runs[1::2])
+    assert not np.all(runs[0] == runs[1])
+    assert date2secs(dates[2]) == secs[1]
+
+    with pytest.raises(ValueError):
+        time_context(mjd=[61406, 61041], tai_utc=[38.0, 37.0])
+
+
+def test_time_context_file(tmp_path):
+    """A context read from a file reports the file and its leap seconds."""
+    taiutc = os.path.join(os.path.dirname(os.path.dirname(__file__)), 'tai-utc.dat')
+    if not os.path.exists(taiutc):
+        pytest.skip('no tai-utc.dat in the source tree')
+    leapfile = tmp_path / 'tai-utc.dat'
+    with open(taiutc) as fh:
+        leapfile.write_text(fh.read())
+    context = time_context(str(leapfile))
+    assert context.file == str(leapfile)
+    mjd, tai_utc = context.leaps
+    assert len(mjd) == leap_table_info()['entries']
+    assert np.all(mjd == time_context().leaps[0])
+    assert time_context(mjd=mjd, tai_utc=tai_utc).file == ''
+
+
+def test_conversion_stats():
+    reset_conversion_stats()
+    stats = conversion_stats()
+    if stats is None:
+        pytest.skip('built without conversion statistics')
+    assert not any(stats['counters'].values())
+
+    convert_vals(['2012:001:00:00:00.000', '2016:366:23:59:60.500', 'junk', '2012:001'],
+                 'date', 'secs', return_valid=True)
+    stats = conversion_stats()
+    counters = stats['counters']
+    assert counters['set_date'] == 2
+    assert counters['set_utc'] == 2
+    assert counters['input_rejected'] == 2
+    assert counters['buffer_converted'] == 2
+    assert counters['leap_second'] == 1
+    assert stats['histograms']['buffer'].sum() == 4
+
+    # MET time inside the 2016 leap second
+    secs2date([599616068.684])
+    assert conversion_stats()['counters']['leap_second'] == 2
+
+    # Array conversions are allocation-free; axTime3 allocates one XTime per call
+    allocs = conversion_stats()['allocations']
+    assert allocs['convert_buffer']['calls'] == 2
+    assert not any(allocs['convert_buffer']['allocs'].values())
+    convert('2012:001:00:00:00.000', fmt_in='date', fmt_out='secs')
+    allocs = conversion_stats()['allocations']
+    assert allocs['axtime3']['calls'] == 1
+    assert allocs['axtime3']['allocs'] == {'XTime': 1, 'XTimeRange': 0, 'XTRList': 0}
+    assert allocs['frees']['XTime'] == 1
+
+    reset_conversion_stats()
+    assert not any(conversion_stats()['counters'].values())
+
+
+def test_conversion_trace(tmp_path):
+    import json
+    filename = str(tmp_path / 'trace.json')
+    if not start_conversion_trace(filename, sample=100):
+        pytest.skip('built without tracing')
+    dates = np.repeat(np.array(['2012:001:00:00:00.000', '2016:366:23:59:60.500']), 1000)
+    date2secs(dates)
+    info = stop_conversion_trace()
+    assert stop_conversion_trace() is None
+
+    with open(filename) as fh:
+        events = json.load(fh)['traceEvents']
+    assert info == {'events': len(events), 'dropped': 0}
+    names = [event['name'] for event in events]
+    for name in ('convert_vals.format', 'convert_vals.encode', 'convert_vals.postprocess',
+                 'convert_buffer.prepare', '_convert_buffer'):
+        assert names.count(name) == 1
+    # One time in 100 is traced
+    for name in ('getinput', 'XTime::set(date)', 'XTime::set', 'putoutput', 'XTime::get'):
+        assert names.count(name) == 20
+    assert all(event['ph'] == 'X' and event['dur'] >= 0 for event in events)
+
+    start_conversion_trace(filename, sample=1, max_events=10)
+    date2secs(dates)
+    assert stop_conversion_trace() == {'events': 10, 'dropped': 5 * 2000 + 5 - 10}
+
+
 def test_secs2date():
     vals = DateTime(['2012:001', '2000:001'])
     assert np.all(secs2date(vals.secs) == vals.date)
@@ -193,6 +549,50 @@ def test_start_day():
     assert DateTime('1996367.010203').day_start().iso == '1997-01-01 00:00:00.000'
 
 
+def _fields_from_strings(secs):
+    """UTC fields, day start and day end of ``secs`` as the pure-Python
+    DateTime.time_attributes, day_start and day_end found them: by slicing
+    the date and iso strings."""
+    date = secs2date(secs)
+    iso = DateTime(secs, format='secs').iso
+    mjd = DateTime(secs, format='secs').mjd
+    monday_mjd = DateTime('2015:159:00:00:00').mjd
+    fields = {'year': int(date[0:4]), 'yday': int(date[5:8]), 'hour': int(date[9:11]),
+              'min': int(date[12:14]), 'sec': float(date[15:]), 'mon': int(iso[5:7]),
+              'day': int(iso[8:10]), 'wday': int(np.mod(np.floor(mjd - monday_mjd), 7))}
+    start = date2secs('{}:{}:00:00:00'.format(date[0:4], date[5:8]))
+    end = date2secs('{}:{:03d}:00:00:00'.format(date[0:4], int(date[5:8]) + 1))
+    return fields, start, end
+
+
+def test_time_fields_native():
+    """The native time fields, day start and day end match those found from
+    the date strings: rounding up to midnight, inside a leap second, at the
+    end of leap and other years, and for weekdays across 1998.0."""
+    from .. import _axTime3 as axTime3
+    dates = ['2015:180:23:59:59.9995', '2015:180:23:59:59.9996', '2015:365:23:59:59.9999',
+             '2016:366:23:59:60.500', '2016:366:23:59:60.9996', '2016:366:12:00:00.000',
+             '2015:365:12:00:00.000', '2012:366:23:59:59.000', '1996:366:01:02:03.000']
+    secs = np.concatenate([date2secs(dates), np.arange(-4 * 86400.0, 4 * 86400.0, 21600.0) - 0.5])
+    fields = axTime3.time_fields(secs, 3)
+    start = axTime3.day_start(secs)
+    end = axTime3.day_start(secs, 1)
+    for i, t in enumerate(secs):
+        expected, expected_start, expected_end = _fields_from_strings(t)
+        assert {name: fields[name][i] for name in expected} == expected, secs2date(t)
+        assert start[i] == expected_start, secs2date(t)
+        assert end[i] == expected_end, secs2date(t)
+
+    leap = dates.index('2016:366:23:59:60.500')
+    assert (fields['yday'][leap], fields['sec'][leap]) == (366, 60.5)
+    assert secs2date(end[leap]) == '2017:001:00:00:00.000'
+    assert secs2date(end[dates.index('2015:365:12:00:00.000')]) == '2016:001:00:00:00.000'
+    # Rounded up to midnight: the date is Tuesday, the weekday that of the MJD
+    assert (fields['hour'][1], fields['day'][1], fields['wday'][1]) == (0, 30, 0)
+    # MET 0 is 1997-12-31 23:58:56.816 UTC: from Saturday 1997 Dec 27 on
+    assert list(fields['wday'][len(dates):][::4]) == [5, 6, 0, 1, 2, 3, 4, 5]
+
+
 def test_year_doy():
     assert DateTime(20483020.0).year_doy == '1998:238'
     assert DateTime('2004:121').date == '2004:121:00:00:00.000'
@@ -229,6 +629,44 @@ def test_sub_datetimes_array():
     assert np.all(delta_days == np.array([7, 6]))
 
 
+def test_sub_whole_days_exact():
+    """Differences of times on whole UTC days are exact whole days."""
+    assert DateTime('2015:001') - DateTime('1999:001') == 5844.0
+    np.random.seed(3)
+    dates = ['{}:{:03d}:00:00:00.000'.format(year, day)
+             for year, day in zip(np.random.randint(1990, 2035, 500),
+                                  np.random.randint(1, 366, 500))]
+    delta = DateTime(np.array(dates)) - DateTime(np.array(dates[::-1]))
+    assert np.all(delta == np.round(delta))
+    assert DateTime('2015:001:12:34:56.789') - DateTime('2015:001') == 45296.789 / 86400
+
+
+def test_arith_broadcast_and_kind():
+    """Arithmetic broadcasts like numpy and keeps lists as lists."""
+    dates = DateTime(np.array(['2015:001', '2015:002']))
+    out = dates + np.array([[0], [1.5]])
+    assert out.date.tolist() == [['2015:001:00:00:00.000', '2015:002:00:00:00.000'],
+                                 ['2015:002:12:00:00.000', '2015:003:12:00:00.000']]
+    assert np.all(dates - DateTime('2015:001') == [0, 1])
+
+    dates = DateTime(['2015:001', '2015:002'])
+    assert (dates + 1).date == ['2015:002:00:00:00.000', '2015:003:00:00:00.000']
+    assert (dates - 1).date == ['2014:365:00:00:00.000', '2015:001:00:00:00.000']
+    assert dates - DateTime('2015:001') == [0.0, 1.0]
+    assert isinstance(DateTime('2015:001') + 1, DateTime)
+    assert isinstance(DateTime('2015:002') - DateTime('2015:001'), float)
+
+
+def test_arith_across_leap_second():
+    """Days are UTC days: one across the 2016:366 leap second is 86401 s."""
+    before = DateTime('2016:366:12:00:00')
+    after = DateTime('2017:001:12:00:00')
+    assert after - before == 1.0
+    assert (before + 1).date == after.date
+    assert (after - 1).date == before.date
+    assert after.secs - before.secs == 86401
+
+
 def test_init_from_DateTime():
     date1 = DateTime('2001:001')
     date2 = DateTime(date1)
@@ -281,6 +719,14 @@ def test_leapsec_2016():
     np.isclose(t2 - t1, 1.0)
 
 
+def test_leapsec_date_round_trip():
+    """
+    Date strings inside a leap second convert back to themselves.
+    """
+    dates = ['2015:181:23:59:60.000', '2016:366:23:59:60.500', '2016:366:23:59:60.999']
+    assert list(convert_vals(dates, 'date', 'date')) == dates
+
+
 def test_date_now():
     """
     Make sure that instantiating a DateTime object as NOW uses the
@@ -316,3 +762,16 @@ def test_date_attributes():
                       ('day', 9),
                       ('wday', 1)):
         assert getattr(t, attr) == val
+
+
+def test_convert_array_mixed_formats():
+    vals = np.array([['2012:001:00:00:00.000', '2012-01-01T00:01:06.184'],
+                     ['2012Jan01 at 00:00:00.000', '2012:001']])
+    secs = convert(vals)
+    assert secs.shape == (2, 2)
+    assert np.allclose(secs, DateTime('2012:001').secs, rtol=0, atol=1e-6)
+    dates = convert(secs, fmt_out='date')
+    assert dates.shape == (2, 2)
+    assert np.all(dates == '2012:001:00:00:00.000')
+    with pytest.raises(ValueError):
+        convert(np.array(['2012:001:00:00:00.000', 'not a date']))
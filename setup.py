@@ -1,4 +1,5 @@
 # Licensed under a 3-clause BSD style license - see LICENSE.rst
+import os
 import platform
 import sys
 
@@ -20,11 +21,28 @@ else:
 if os_name == "Darwin":
     compile_args += ["-stdlib=libc++"]
 
+# Set CHANDRA_TIME_STATS to build with conversion counters, latency
+# histograms and allocation accounting (see chandra_time/XTimeStats.h and
+# chandra_time.Time.conversion_stats), and CHANDRA_TIME_TRACE to build with
+# trace spans (see chandra_time/XTimeTrace.h and
+# chandra_time.Time.start_conversion_trace)
+define_macros = [("XTIME_STATS", "1")] if os.environ.get("CHANDRA_TIME_STATS") else []
+if os.environ.get("CHANDRA_TIME_TRACE"):
+    define_macros.append(("XTIME_TRACE", "1"))
+
+# Compile the leap second table of chandra_time/tai-utc.dat into the library
+# (chandra_time/XTimeLeaps.h, regenerated here when the table changes)
+if "--version" not in sys.argv[1:]:
+    import setup_leaps
+
+    setup_leaps.update_header()
+
 extensions = [
     Extension(
         "chandra_time._axTime3",
         ["chandra_time/_axTime3.pyx"],
         extra_compile_args=compile_args,
+        define_macros=define_macros,
     )
 ]
 
@@ -0,0 +1,131 @@
+# Licensed under a 3-clause BSD style license - see LICENSE.rst
+"""
+Generate the built-in leap second table of XTime, chandra_time/XTimeLeaps.h,
+from the USNO leap second file chandra_time/tai-utc.dat::
+
+  python setup_leaps.py [--dat FILE] [--header FILE]
+
+setup.py and bench/Makefile run this before compiling.  The header only
+depends on the leap seconds in tai-utc.dat, and is only rewritten when they
+change.  XTime replaces the built-in table by ``$TIMING_DIR/tai-utc.dat`` or
+``$ASC_DATA/tai-utc.dat`` only if that file has other leap seconds.
+To add a leap second, append its line to chandra_time/tai-utc.dat and rebuild.
+"""
+import argparse
+import os
+import re
+import sys
+
+PKG_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'chandra_time')
+TAIUTC = os.path.join(PKG_DIR, 'tai-utc.dat')
+HEADER = os.path.join(PKG_DIR, 'XTimeLeaps.h')
+
+# Same fields as XTime::scanLeapLine
+LINE = re.compile(r'\s*(\d+)\s+(\w+)\s+1\s+=JD\s+24(\d+)\.5\s+\S+\s+([-+.\dEe]+)\s+S\s+\+')
+
+TEMPLATE = """\
+//----------------------------------------------------------------------
+//
+// File Name   : XTimeLeaps.h
+// Subsystem   : XFF
+// Description : Built-in leap second table
+//
+// .SECTION DESCRIPTION
+// Generated from tai-utc.dat by setup_leaps.py; do not edit.
+//
+// XTime starts from this table, so that programs convert times without
+// any file, and only replaces it by $TIMING_DIR/tai-utc.dat or
+// $ASC_DATA/tai-utc.dat if that file has a different number of leap
+// seconds or a different last one.
+//
+// Leap seconds: {num} entries, {first} through {last}
+//
+//----------------------------------------------------------------------
+//
+
+#ifndef XTIMELEAPS_H
+#define XTIMELEAPS_H
+
+constexpr int    XTIME_LEAPS_BUILTIN_NUM = {num} ;
+constexpr long   XTIME_LEAPS_BUILTIN_MJD[] = {{{mjds}}} ;
+constexpr double XTIME_LEAPS_BUILTIN_SECS[] = {{{secs}}} ;
+
+#endif
+"""
+
+
+def read_leaps(filename):
+    """
+    Return the leap seconds since 1972 in ``filename`` as a list of
+    (year, month, MJD, TAI-UTC) tuples, checking that the MJDs increase and
+    TAI-UTC does not decrease.
+    """
+    leaps = []
+    with open(filename) as fh:
+        for lineno, line in enumerate(fh, 1):
+            match = LINE.match(line)
+            if not match:
+                raise ValueError('{}:{}: not a tai-utc.dat line'.format(filename, lineno))
+            year, month, mjd, secs = match.groups()
+            if int(year) <= 1970:
+                continue
+            if leaps and int(mjd) <= leaps[-1][2]:
+                raise ValueError('{}:{}: MJD {} does not increase'.format(filename, lineno, mjd))
+            if leaps and float(secs) < leaps[-1][3]:
+                raise ValueError('{}:{}: TAI-UTC {} decreases'.format(filename, lineno, secs))
+            leaps.append((int(year), month, int(mjd), float(secs)))
+    if not leaps:
+        raise ValueError('{}: no leap seconds since 1972'.format(filename))
+    return leaps
+
+
+def wrap(values, indent):
+    """
+    Return ``values`` joined by commas, in lines of at most 80 characters.
+    """
+    lines = ['']
+    for value in values:
+        if lines[-1] and indent + len(lines[-1]) + len(value) + 4 > 80:
+            lines.append('')
+        lines[-1] += value + ', '
+    return ('\n' + ' ' * indent).join(line.rstrip() for line in lines).rstrip(',')
+
+
+def make_header(leaps):
+    """
+    Return the text of XTimeLeaps.h for table ``leaps`` (see ``read_leaps``).
+    """
+    return TEMPLATE.format(
+        num=len(leaps),
+        first='{} {}  1'.format(*leaps[0][:2]), last='{} {}  1'.format(*leaps[-1][:2]),
+        mjds=wrap(['{}'.format(leap[2]) for leap in leaps], 44),
+        secs=wrap(['{:g}'.format(leap[3]) for leap in leaps], 45))
+
+
+def update_header(dat=TAIUTC, header=HEADER):
+    """
+    Write ``header`` from ``dat`` unless it already holds the same table.
+    Returns True if the header was written.
+    """
+    text = make_header(read_leaps(dat))
+    if os.path.exists(header):
+        with open(header) as fh:
+            if fh.read() == text:
+                return False
+    with open(header, 'w') as fh:
+        fh.write(text)
+    return True
+
+
+def main(args=None):
+    parser = argparse.ArgumentParser(description='Generate XTimeLeaps.h from tai-utc.dat')
+    parser.add_argument('--dat', default=TAIUTC, help='Leap second file (default=%(default)s)')
+    parser.add_argument('--header', default=HEADER, help='Header to write (default=%(default)s)')
+    opt = parser.parse_args(args)
+    if update_header(opt.dat, opt.header):
+        print('Wrote {}'.format(opt.header))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())